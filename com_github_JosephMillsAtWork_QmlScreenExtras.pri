@@ -1,4 +1,63 @@
+QT += qml quick
+CONFIG += c++11
+INCLUDEPATH += $$PWD/src/ScreenExtras
 
 SOURCES += \
-    $$PWD/src/screen.cpp \
-    $$PWD/src/screen.h
+    $$PWD/src/ScreenExtras/screen.cpp \
+    $$PWD/src/ScreenExtras/screenmetrics.cpp \
+    $$PWD/src/ScreenExtras/unitkernels.cpp \
+    $$PWD/src/ScreenExtras/screenextrascore.cpp \
+    $$PWD/src/ScreenExtras/screenprofile.cpp \
+    $$PWD/src/ScreenExtras/deviceprobe.cpp \
+    $$PWD/src/ScreenExtras/profilecache.cpp \
+    $$PWD/src/ScreenExtras/formfactor.cpp \
+    $$PWD/src/ScreenExtras/screenfonts.cpp \
+    $$PWD/src/ScreenExtras/gridunits.cpp \
+    $$PWD/src/ScreenExtras/screentimings.cpp \
+    $$PWD/src/ScreenExtras/screenmodel.cpp \
+    $$PWD/src/ScreenExtras/windowscreen.cpp \
+    $$PWD/src/ScreenExtras/breakpoints.cpp \
+    $$PWD/src/ScreenExtras/screengridlayout.cpp \
+    $$PWD/src/ScreenExtras/framestatistics.cpp \
+    $$PWD/src/ScreenExtras/screenimageprovider.cpp \
+    $$PWD/src/ScreenExtras/screeniconprovider.cpp \
+    $$PWD/src/ScreenExtras/assetresolver.cpp \
+    $$PWD/src/ScreenExtras/componentpreloader.cpp
+
+HEADERS += \
+    $$PWD/src/ScreenExtras/screen.h \
+    $$PWD/src/ScreenExtras/screenextrascore.h \
+    $$PWD/src/ScreenExtras/screenmetrics.h \
+    $$PWD/src/ScreenExtras/unitconverter.h \
+    $$PWD/src/ScreenExtras/unitkernels.h \
+    $$PWD/src/ScreenExtras/screenprofile.h \
+    $$PWD/src/ScreenExtras/deviceprobe.h \
+    $$PWD/src/ScreenExtras/profilecache.h \
+    $$PWD/src/ScreenExtras/formfactor.h \
+    $$PWD/src/ScreenExtras/screenfonts.h \
+    $$PWD/src/ScreenExtras/gridunits.h \
+    $$PWD/src/ScreenExtras/screentimings.h \
+    $$PWD/src/ScreenExtras/screenmodel.h \
+    $$PWD/src/ScreenExtras/windowscreen.h \
+    $$PWD/src/ScreenExtras/breakpoints.h \
+    $$PWD/src/ScreenExtras/screengridlayout.h \
+    $$PWD/src/ScreenExtras/framestatistics.h \
+    $$PWD/src/ScreenExtras/screenimageprovider.h \
+    $$PWD/src/ScreenExtras/screeniconprovider.h \
+    $$PWD/src/ScreenExtras/assetresolver.h \
+    $$PWD/src/ScreenExtras/componentpreloader.h
+
+# CONFIG+=screenextras_tracing sends the timing phases to LTTng, as in ScreenExtras.pro
+screenextras_tracing {
+    QT += core-private
+    DEFINES += QMLSCREENEXTRAS_TRACING
+    LIBS += -llttng-ust -ldl
+
+    TRACEPOINTS = $$PWD/src/ScreenExtras/qmlscreenextras.tracepoints
+    tracegen.input = TRACEPOINTS
+    tracegen.output = $$OUT_PWD/${QMAKE_FILE_BASE}_tracepoints_p.h
+    tracegen.commands = $$[QT_HOST_BINS]/tracegen lttng ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+    tracegen.variable_out = HEADERS
+    tracegen.CONFIG += target_predeps no_link
+    QMAKE_EXTRA_COMPILERS += tracegen
+}
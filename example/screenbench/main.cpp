@@ -0,0 +1,601 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include <QGuiApplication>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QtTest>
+#include <cmath>
+#include <limits>
+
+#include "screen.h"
+#include "unitconverter.h"
+#include "unitkernels.h"
+#include "screenimageprovider.h"
+#include "screenmetrics.h"
+#include "screenextras_plugin.h"
+
+// Opens up the update steps that are protected in ScreenExtrasCore
+class BenchScreenExtras : public ScreenExtrasCore
+{
+public:
+    using ScreenExtrasCore::initialize;
+    using ScreenExtrasCore::updateFormFactor;
+    using ScreenExtrasCore::updateFonts;
+};
+
+class ScreenBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void singletonConstruction();
+    void sharedConstruction();
+    void initialize();
+    void updateFormFactor();
+    void updateFonts();
+
+    void cppCalls_data();
+    void cppCalls();
+
+    void qmlCalls_data();
+    void qmlCalls();
+
+    void scene_data();
+    void scene();
+
+    void batch_data();
+    void batch();
+
+    void kernels_data();
+    void kernels();
+
+    void kernelsMatchLoop_data();
+    void kernelsMatchLoop();
+
+    void gridLayout_data();
+    void gridLayout();
+
+    void gridLayoutIncremental_data();
+    void gridLayoutIncremental();
+
+    void imageWithoutSize();
+
+private:
+    QObject *createFromQml(const QByteArray &qml);
+
+    QQmlEngine *m_engine;
+};
+
+void ScreenBench::initTestCase()
+{
+    ScreenExtrasPlugin plugin;
+    plugin.registerTypes("QmlScreenExtras");
+
+    m_engine = new QQmlEngine(this);
+}
+
+QObject *ScreenBench::createFromQml(const QByteArray &qml)
+{
+    QQmlComponent component(m_engine);
+    component.setData(qml, QUrl());
+    QObject *object = component.create();
+    if (!object)
+        qWarning() << component.errors();
+    return object;
+}
+
+void ScreenBench::singletonConstruction()
+{
+    QBENCHMARK {
+        ScreenExtras screenExtras;
+        Q_UNUSED(screenExtras)
+    }
+}
+
+// what every further engine pays once the screens are known
+void ScreenBench::sharedConstruction()
+{
+    ScreenExtras first;
+    QBENCHMARK {
+        ScreenExtras screenExtras;
+        Q_UNUSED(screenExtras)
+    }
+}
+
+void ScreenBench::initialize()
+{
+    BenchScreenExtras screenExtras;
+    QScreen *screen = QGuiApplication::primaryScreen();
+    QBENCHMARK {
+        screenExtras.initialize(screen);
+    }
+}
+
+void ScreenBench::updateFormFactor()
+{
+    BenchScreenExtras screenExtras;
+    QBENCHMARK {
+        screenExtras.updateFormFactor();
+    }
+}
+
+void ScreenBench::updateFonts()
+{
+    BenchScreenExtras screenExtras;
+    QBENCHMARK {
+        screenExtras.updateFonts();
+    }
+}
+
+void ScreenBench::cppCalls_data()
+{
+    QTest::addColumn<QByteArray>("method");
+
+    QTest::newRow("gu()") << QByteArray("gu");
+    QTest::newRow("font()") << QByteArray("font");
+    QTest::newRow("screenNameAt()") << QByteArray("screenNameAt");
+    QTest::newRow("UnitConverter::gu()") << QByteArray("converter");
+}
+
+void ScreenBench::cppCalls()
+{
+    QFETCH(QByteArray, method);
+
+    ScreenExtras screenExtras;
+    const UnitConverter units = UnitConverter::current();
+    double sum = 0;
+    QBENCHMARK {
+        if (method == "gu")
+            sum += screenExtras.gu(2);
+        else if (method == "font")
+            sum += screenExtras.font(ScreenExtras::NORMAL);
+        else if (method == "converter")
+            sum += units.gu(2);
+        else
+            sum += screenExtras.screenNameAt(0).length();
+    }
+    QVERIFY(sum >= 0);
+}
+
+void ScreenBench::qmlCalls_data()
+{
+    QTest::addColumn<QByteArray>("expression");
+
+    QTest::newRow("gu()") << QByteArray("ScreenExtras.gu(2)");
+    QTest::newRow("gridUnit") << QByteArray("ScreenExtras.gridUnit * 2");
+    QTest::newRow("units") << QByteArray("ScreenExtras.units.gu2");
+    QTest::newRow("font()") << QByteArray("ScreenExtras.font(ScreenExtras.NORMAL)");
+    QTest::newRow("fonts") << QByteArray("ScreenExtras.fonts.normal");
+    QTest::newRow("screenNameAt()") << QByteArray("ScreenExtras.screenNameAt(0).length");
+}
+
+// 1000 evaluations from JavaScript per iteration
+void ScreenBench::qmlCalls()
+{
+    QFETCH(QByteArray, expression);
+
+    QScopedPointer<QObject> object(createFromQml(
+        "import QtQml 2.2\n"
+        "import QmlScreenExtras 1.0\n"
+        "QtObject {\n"
+        "    function run(count) {\n"
+        "        var sum = 0;\n"
+        "        for (var i = 0; i < count; ++i)\n"
+        "            sum += " + expression + ";\n"
+        "        return sum;\n"
+        "    }\n"
+        "}\n"));
+    QVERIFY(object);
+
+    QBENCHMARK {
+        QVariant result;
+        QMetaObject::invokeMethod(object.data(), "run", Q_RETURN_ARG(QVariant, result),
+                                  Q_ARG(QVariant, 1000));
+    }
+}
+
+void ScreenBench::scene_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QByteArray>("delegate");
+
+    const QByteArray invokables =
+            "Rectangle {\n"
+            "    width: ScreenExtras.gu(10); height: ScreenExtras.gu(4)\n"
+            "    Text { text: index; font.pixelSize: ScreenExtras.font(ScreenExtras.NORMAL) }\n"
+            "}\n";
+    const QByteArray properties =
+            "Rectangle {\n"
+            "    width: ScreenExtras.units.gu10; height: ScreenExtras.units.gu4\n"
+            "    Text { text: index; font.pixelSize: ScreenExtras.fonts.normal }\n"
+            "}\n";
+
+    QTest::newRow("1000 gu()") << 1000 << invokables;
+    QTest::newRow("5000 gu()") << 5000 << invokables;
+    QTest::newRow("1000 units") << 1000 << properties;
+    QTest::newRow("5000 units") << 5000 << properties;
+}
+
+// Making and dropping a scene of count delegates that bind to ScreenExtras
+void ScreenBench::scene()
+{
+    QFETCH(int, count);
+    QFETCH(QByteArray, delegate);
+
+    const QByteArray qml =
+            "import QtQuick 2.3\n"
+            "import QmlScreenExtras 1.0\n"
+            "Item {\n"
+            "    Repeater {\n"
+            "        model: " + QByteArray::number(count) + "\n"
+            + delegate +
+            "    }\n"
+            "}\n";
+
+    QQmlComponent component(m_engine);
+    component.setData(qml, QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QBENCHMARK {
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY(object);
+    }
+}
+
+void ScreenBench::batch_data()
+{
+    QTest::addColumn<QByteArray>("conversion");
+
+    QTest::newRow("gu() per element")
+            << QByteArray("for (var i = 0; i < points.length; ++i) px[i] = ScreenExtras.gu(points[i]);");
+    QTest::newRow("guArray()")
+            << QByteArray("px = ScreenExtras.guArray(points);");
+    QTest::newRow("guBuffer()")
+            << QByteArray("px = new Float32Array(ScreenExtras.guBuffer(buffer.buffer));");
+    QTest::newRow("snapBuffer()")
+            << QByteArray("px = new Float32Array(ScreenExtras.snapBuffer(buffer.buffer));");
+}
+
+// 100000 grid unit coordinates from JavaScript per iteration
+void ScreenBench::batch()
+{
+    QFETCH(QByteArray, conversion);
+
+    QScopedPointer<QObject> object(createFromQml(
+        "import QtQml 2.2\n"
+        "import QmlScreenExtras 1.0\n"
+        "QtObject {\n"
+        "    property var points\n"
+        "    property var buffer\n"
+        "    Component.onCompleted: {\n"
+        "        var p = new Array(100000);\n"
+        "        for (var i = 0; i < p.length; ++i)\n"
+        "            p[i] = i * 0.01;\n"
+        "        points = p;\n"
+        "        buffer = new Float32Array(p);\n"
+        "    }\n"
+        "    function run() {\n"
+        "        var px = new Array(points.length);\n"
+        "        " + conversion + "\n"
+        "        return px.length;\n"
+        "    }\n"
+        "}\n"));
+    QVERIFY(object);
+
+    QBENCHMARK {
+        QVariant result;
+        QMetaObject::invokeMethod(object.data(), "run", Q_RETURN_ARG(QVariant, result));
+    }
+}
+
+void ScreenBench::kernels_data()
+{
+    QTest::addColumn<QByteArray>("kernel");
+
+    QTest::newRow("loop") << QByteArray("loop");
+    QTest::newRow("UnitKernels::scale()") << QByteArray("scale");
+    QTest::newRow("UnitKernels::snap()") << QByteArray("snap");
+}
+
+// 100000 floats to pixels and back in place per iteration
+void ScreenBench::kernels()
+{
+    QFETCH(QByteArray, kernel);
+
+    const UnitConverter units = UnitConverter::current();
+    QVector<float> values(100000);
+    for (int i = 0; i < values.size(); ++i)
+        values[i] = i * 0.01f;
+
+    QBENCHMARK {
+        if (kernel == "loop")
+        {
+            for (int i = 0; i < values.size(); ++i)
+                values[i] = float(units.gu(values[i]));
+            for (int i = 0; i < values.size(); ++i)
+                values[i] = float(units.pxToGu(values[i]));
+        }
+        else if (kernel == "scale")
+        {
+            UnitKernels::scale(values, float(units.gridUnit()));
+            UnitKernels::scale(values, float(1.0 / units.gridUnit()));
+        }
+        else
+        {
+            UnitKernels::snap(values, float(units.devicePixelRatio()));
+        }
+    }
+}
+
+void ScreenBench::kernelsMatchLoop_data()
+{
+    QTest::addColumn<double>("devicePixelRatio");
+
+    QTest::newRow("1") << 1.0;
+    QTest::newRow("1.25") << 1.25;
+    QTest::newRow("1.5") << 1.5;
+    QTest::newRow("2") << 2.0;
+    QTest::newRow("2.75") << 2.75;
+}
+
+namespace {
+
+template <typename T>
+bool snapsLikeLoop(T devicePixelRatio)
+{
+    const T infinity = std::numeric_limits<T>::infinity();
+    // 11 values, so each one lands in every SIMD lane and in the scalar tail
+    const T special[] = { T(0.5) / devicePixelRatio, T(1.5) / devicePixelRatio, T(-2.5) / devicePixelRatio,
+                          std::numeric_limits<T>::quiet_NaN(), infinity, -infinity,
+                          T(3e9), T(-3e9), T(1e30), T(-0.2), T(12.3456) };
+    const int specialCount = sizeof(special) / sizeof(special[0]);
+
+    foreach (int count, QList<int>() << 1 << 2 << 3 << 4 << 5 << 7 << 9 << 13 << 1003)
+    {
+        QVector<T> values(count);
+        for (int i = 0; i < count; ++i)
+            values[i] = special[i % specialCount];
+
+        QVector<T> expected = values;
+        for (int i = 0; i < count; ++i)
+            expected[i] = std::nearbyint(expected[i] * devicePixelRatio) / devicePixelRatio;
+
+        UnitKernels::snap(values.data(), count, devicePixelRatio);
+        for (int i = 0; i < count; ++i)
+        {
+            if (!(values.at(i) == expected.at(i) || (std::isnan(values.at(i)) && std::isnan(expected.at(i)))))
+            {
+                qWarning() << "snap() of" << special[i % specialCount] << "at" << i << "of" << count
+                           << "gave" << values.at(i) << "instead of" << expected.at(i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// The SIMD part of snap() has to give the same bits as the plain loop for every value
+void ScreenBench::kernelsMatchLoop()
+{
+    QFETCH(double, devicePixelRatio);
+
+    QVERIFY(snapsLikeLoop<float>(float(devicePixelRatio)));
+    QVERIFY(snapsLikeLoop<double>(devicePixelRatio));
+
+    const UnitConverter units = UnitConverter::current();
+    QVector<double> values = QVector<double>() << 0.3 << 7.5 << 12.25 << 100.1 << 1001.7;
+    UnitKernels::snap(values.data(), values.size(), units.devicePixelRatio());
+    QCOMPARE(values, QVector<double>() << units.snap(0.3) << units.snap(7.5) << units.snap(12.25)
+                                       << units.snap(100.1) << units.snap(1001.7));
+}
+
+void ScreenBench::gridLayout_data()
+{
+    QTest::addColumn<QByteArray>("grid");
+
+    const QByteArray bindings =
+            "    property real spacing: ScreenExtras.gu(1)\n"
+            "    property real columnWidth: (width - spacing * 11) / 12\n"
+            "    function resize(w) { width = w }\n"
+            "    Repeater {\n"
+            "        model: count\n"
+            "        Rectangle {\n"
+            "            x: (index % 12) * (root.columnWidth + root.spacing)\n"
+            "            y: Math.floor(index / 12) * (ScreenExtras.gu(10) + root.spacing)\n"
+            "            width: root.columnWidth; height: ScreenExtras.gu(10)\n"
+            "        }\n"
+            "    }\n";
+    const QByteArray anchors =
+            "    property real spacing: ScreenExtras.gu(1)\n"
+            "    property real columnWidth: (width - spacing * 11) / 12\n"
+            "    function resize(w) { width = w }\n"
+            "    Repeater {\n"
+            "        model: count\n"
+            "        Rectangle {\n"
+            "            anchors.left: parent.left\n"
+            "            anchors.leftMargin: (index % 12) * (root.columnWidth + root.spacing)\n"
+            "            anchors.top: parent.top\n"
+            "            anchors.topMargin: Math.floor(index / 12) * (ScreenExtras.gu(10) + root.spacing)\n"
+            "            width: root.columnWidth; height: ScreenExtras.gu(10)\n"
+            "        }\n"
+            "    }\n";
+    const QByteArray layout =
+            "    function resize(w) { width = w; grid.forceLayout() }\n"
+            "    ScreenGridLayout {\n"
+            "        id: grid\n"
+            "        width: root.width; columns: 12; rowHeight: 10\n"
+            "        Repeater {\n"
+            "            model: count\n"
+            "            Rectangle { }\n"
+            "        }\n"
+            "    }\n";
+
+    QTest::newRow("1000 bindings") << QByteArray("1000\n" + bindings);
+    QTest::newRow("5000 bindings") << QByteArray("5000\n" + bindings);
+    QTest::newRow("1000 anchors") << QByteArray("1000\n" + anchors);
+    QTest::newRow("5000 anchors") << QByteArray("5000\n" + anchors);
+    QTest::newRow("1000 ScreenGridLayout") << QByteArray("1000\n" + layout);
+    QTest::newRow("5000 ScreenGridLayout") << QByteArray("5000\n" + layout);
+}
+
+// Making a grid of tiles in grid units and resizing it a few times
+void ScreenBench::gridLayout()
+{
+    QFETCH(QByteArray, grid);
+
+    const QByteArray qml =
+            "import QtQuick 2.3\n"
+            "import QmlScreenExtras 1.0\n"
+            "Item {\n"
+            "    id: root\n"
+            "    width: 800\n"
+            "    property int count: " + grid +
+            "}\n";
+
+    QQmlComponent component(m_engine);
+    component.setData(qml, QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QBENCHMARK {
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY(object);
+        foreach (int width, QList<int>() << 1024 << 640 << 1280 << 800)
+            QMetaObject::invokeMethod(object.data(), "resize", Q_ARG(QVariant, width));
+    }
+}
+
+void ScreenBench::gridLayoutIncremental_data()
+{
+    QTest::addColumn<QVariantList>("before");
+    QTest::addColumn<QVariantList>("after");
+
+    QTest::newRow("first cell narrower")
+            << (QVariantList() << 3 << 2 << 2 << 1 << 4 << 1)
+            << (QVariantList() << 3 << 1 << 2 << 1 << 4 << 1);
+    QTest::newRow("first cell wider")
+            << (QVariantList() << 1 << 1 << 2 << 2 << 2 << 1)
+            << (QVariantList() << 1 << 1 << 4 << 2 << 2 << 1);
+    QTest::newRow("middle cell narrower")
+            << (QVariantList() << 2 << 2 << 1 << 3 << 1 << 3)
+            << (QVariantList() << 2 << 2 << 1 << 1 << 1 << 3);
+    QTest::newRow("every cell narrower")
+            << (QVariantList() << 4 << 4 << 4 << 4 << 4 << 4)
+            << (QVariantList() << 1 << 1 << 1 << 1 << 1 << 1);
+}
+
+// After a span changed, laying out from the changed row has to give the same grid as from scratch
+void ScreenBench::gridLayoutIncremental()
+{
+    QFETCH(QVariantList, before);
+    QFETCH(QVariantList, after);
+
+    const QByteArray qml =
+            "import QtQuick 2.3\n"
+            "import QmlScreenExtras 1.0\n"
+            "ScreenGridLayout {\n"
+            "    id: grid\n"
+            "    property var spans: []\n"
+            "    width: 800; columns: 4; rowHeight: 2\n"
+            "    Repeater {\n"
+            "        model: grid.spans.length\n"
+            "        Item { ScreenGridLayout.columnSpan: grid.spans[index] }\n"
+            "    }\n"
+            "}\n";
+
+    QQmlComponent component(m_engine);
+    component.setData(qml, QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QList<QRectF> layouts[2];
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        QScopedPointer<QObject> object(component.create());
+        QQuickItem *grid = qobject_cast<QQuickItem *>(object.data());
+        QVERIFY(grid);
+
+        // the first pass goes through before, the second starts out with after
+        grid->setProperty("spans", pass == 0 ? before : after);
+        QMetaObject::invokeMethod(grid, "forceLayout");
+        if (pass == 0)
+        {
+            grid->setProperty("spans", after);
+            QMetaObject::invokeMethod(grid, "forceLayout");
+        }
+
+        foreach (QQuickItem *child, grid->childItems())
+        {
+            if (!child->inherits("QQuickRepeater"))
+                layouts[pass].append(QRectF(child->position(), child->size()));
+        }
+        QCOMPARE(layouts[pass].size(), after.size());
+    }
+
+    QCOMPARE(layouts[0], layouts[1]);
+}
+
+// An id without a size falls back to the size the Image asks for
+void ScreenBench::imageWithoutSize()
+{
+    QSizeF units;
+    QCOMPARE(ScreenImageProvider::parseId(QStringLiteral("/tmp/photo.png"), &units), QStringLiteral("/tmp/photo.png"));
+    QVERIFY(!units.isValid());
+    QCOMPARE(ScreenImageProvider::parseId(QStringLiteral("12/qrc:/photo.png"), &units), QStringLiteral("qrc:/photo.png"));
+    QCOMPARE(units, QSizeF(12, 0));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + QStringLiteral("/photo.png");
+    QImage photo(400, 200, QImage::Format_RGB32);
+    photo.fill(Qt::darkCyan);
+    QVERIFY(photo.save(path));
+
+    ScreenExtras screenExtras;
+    const double devicePixelRatio = ScreenMetrics::current()->devicePixelRatio;
+    QString error;
+    const QImage image = ScreenImageProvider::decode(path, QSize(50, 0), &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(image.width(), qMin(400, qRound(50 * devicePixelRatio)));
+    QCOMPARE(image.height(), image.width() / 2);
+
+    QCOMPARE(ScreenImageProvider::decode(path, QSize(), &error).size(), QSize(400, 200));
+}
+
+int main(int argc, char *argv[])
+{
+    // headless unless told otherwise
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    ScreenBench bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "main.moc"
@@ -0,0 +1,20 @@
+TEMPLATE = app
+TARGET = screenbench
+
+QT += qml quick testlib
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# Built straight from the sources so the protected update steps can be timed
+include($$PWD/../../com_github_JosephMillsAtWork_QmlScreenExtras.pri)
+INCLUDEPATH += $$PWD/../../src/ScreenExtras
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/ScreenExtras/screenextras_plugin.cpp
+
+HEADERS += \
+    $$PWD/../../src/ScreenExtras/screenextras_plugin.h
+
+target.path = $$[QT_INSTALL_EXAMPLES]/qmlscreenextras/screenbench/
+INSTALLS += target
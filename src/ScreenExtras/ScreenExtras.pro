@@ -14,13 +14,68 @@ uri = QmlScreenExtras
 # Input
 SOURCES += \
     screenextras_plugin.cpp \
-    screen.cpp
+    screen.cpp \
+    screenmetrics.cpp \
+    unitkernels.cpp \
+    screenextrascore.cpp \
+    screenprofile.cpp \
+    deviceprobe.cpp \
+    profilecache.cpp \
+    formfactor.cpp \
+    screenfonts.cpp \
+    gridunits.cpp \
+    screentimings.cpp \
+    screenmodel.cpp \
+    windowscreen.cpp \
+    breakpoints.cpp \
+    screengridlayout.cpp \
+    framestatistics.cpp \
+    screenimageprovider.cpp \
+    screeniconprovider.cpp \
+    assetresolver.cpp \
+    componentpreloader.cpp
 
 HEADERS += \
     screenextras_plugin.h \
-    screen.h
+    screen.h \
+    screenextrascore.h \
+    screenmetrics.h \
+    unitconverter.h \
+    unitkernels.h \
+    screenprofile.h \
+    deviceprobe.h \
+    profilecache.h \
+    formfactor.h \
+    screenfonts.h \
+    gridunits.h \
+    screentimings.h \
+    screenmodel.h \
+    windowscreen.h \
+    breakpoints.h \
+    screengridlayout.h \
+    framestatistics.h \
+    screenimageprovider.h \
+    screeniconprovider.h \
+    assetresolver.h \
+    componentpreloader.h
 
-DISTFILES = qmldir
+DISTFILES = qmldir \
+    qmlscreenextras.tracepoints
+
+# qmake CONFIG+=screenextras_tracing sends the timing phases to LTTng
+screenextras_tracing {
+    QT += core-private
+    DEFINES += QMLSCREENEXTRAS_TRACING
+    LIBS += -llttng-ust -ldl
+
+    TRACEPOINTS = qmlscreenextras.tracepoints
+    tracegen.input = TRACEPOINTS
+    tracegen.output = $$OUT_PWD/${QMAKE_FILE_BASE}_tracepoints_p.h
+    tracegen.commands = $$[QT_HOST_BINS]/tracegen lttng ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+    tracegen.variable_out = HEADERS
+    tracegen.CONFIG += target_predeps no_link
+    QMAKE_EXTRA_COMPILERS += tracegen
+}
 
 !equals(_PRO_FILE_PWD_, $$OUT_PWD) {
     copy_qmldir.target = $$OUT_PWD/qmldir
@@ -0,0 +1,387 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "assetresolver.h"
+#include "formfactor.h"
+#include "screentimings.h"
+#include "windowscreen.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QMutex>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QRegularExpression>
+#include <QVector>
+
+struct AssetVariant
+{
+    QString url;
+    double scale;
+    // -1 for every form factor
+    int formFactor;
+};
+
+// Every variant of every asset below one root, by the name without the variant parts
+struct AssetIndex
+{
+    QHash<QString, QVector<AssetVariant> > variants;
+};
+
+namespace {
+
+struct Density
+{
+    const char *name;
+    double scale;
+};
+
+const Density densities[] =
+{
+    { "ldpi", 0.75 },
+    { "mdpi", 1.0 },
+    { "tvdpi", 1.33 },
+    { "hdpi", 1.5 },
+    { "xhdpi", 2.0 },
+    { "xxhdpi", 3.0 },
+    { "xxxhdpi", 4.0 }
+};
+
+// 0 when the folder is not a density bucket, "drawable-xhdpi" is one too
+double densityScale(QString folder)
+{
+    const int dash = folder.lastIndexOf(QLatin1Char('-'));
+    if (dash >= 0)
+        folder = folder.mid(dash + 1);
+
+    for (const Density &density : densities)
+    {
+        if (folder == QLatin1String(density.name))
+            return density.scale;
+    }
+    return 0.0;
+}
+
+QString basePath(const QUrl &root)
+{
+    if (root.scheme() == QLatin1String("qrc"))
+        return QLatin1Char(':') + root.path();
+    if (root.isLocalFile())
+        return root.toLocalFile();
+    return QString();
+}
+
+QString joined(const QUrl &root, const QString &relative)
+{
+    QString url = root.toString();
+    if (!url.endsWith(QLatin1Char('/')))
+        url += QLatin1Char('/');
+    return url + relative;
+}
+
+QSharedPointer<const AssetIndex> scan(const QUrl &root)
+{
+    QSharedPointer<AssetIndex> index(new AssetIndex);
+    const QString base = basePath(root);
+    if (base.isEmpty())
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: assets can only be read from local files and qrc, not" << root;
+        return index;
+    }
+
+    // "home@2x.png" is "home.png" at a scale of 2
+    static const QRegularExpression scaleSuffix(QStringLiteral("^(.+)@([0-9]+(?:\\.[0-9]+)?)x(\\.[^.]+)?$"));
+
+    const QDir baseDir(base);
+    QDirIterator it(base, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString relative = baseDir.relativeFilePath(it.next());
+        const QStringList parts = relative.split(QLatin1Char('/'));
+
+        AssetVariant variant;
+        variant.url = joined(root, relative);
+        variant.scale = 1.0;
+        variant.formFactor = -1;
+
+        QStringList name;
+        for (int i = 0; i < parts.size() - 1; ++i)
+        {
+            const QString folder = parts.at(i).toLower();
+            const double scale = densityScale(folder);
+            bool isFormFactor = false;
+            const FormFactorRules::Type type = FormFactorRules::typeFromName(folder, &isFormFactor);
+
+            if (scale > 0.0)
+                variant.scale = scale;
+            else if (isFormFactor)
+                variant.formFactor = type;
+            else
+                name << parts.at(i);
+        }
+
+        QString fileName = parts.last();
+        const QRegularExpressionMatch match = scaleSuffix.match(fileName);
+        if (match.hasMatch())
+        {
+            variant.scale = match.captured(2).toDouble();
+            fileName = match.captured(1) + match.captured(3);
+        }
+        name << fileName;
+
+        index->variants[name.join(QLatin1Char('/'))].append(variant);
+    }
+    return index;
+}
+
+// one scan per root for the whole process
+struct IndexCache
+{
+    QMutex mutex;
+    QHash<QUrl, QSharedPointer<const AssetIndex> > byRoot;
+};
+
+Q_GLOBAL_STATIC(IndexCache, indexCache)
+
+QSharedPointer<const AssetIndex> indexFor(const QUrl &root)
+{
+    IndexCache *cache = indexCache();
+    QMutexLocker locker(&cache->mutex);
+
+    QSharedPointer<const AssetIndex> index = cache->byRoot.value(root);
+    if (!index)
+    {
+        index = scan(root);
+        cache->byRoot.insert(root, index);
+    }
+    return index;
+}
+
+/*
+  A variant for this form factor beats one for every form factor. Then the
+  smallest scale that is not below the screen's wins, so nothing is scaled
+  up, and without one of those the largest there is.
+*/
+bool isBetter(const AssetVariant &a, const AssetVariant &b, double scale)
+{
+    if ((a.formFactor >= 0) != (b.formFactor >= 0))
+        return a.formFactor >= 0;
+
+    const bool aCovers = a.scale >= scale - 0.01;
+    const bool bCovers = b.scale >= scale - 0.01;
+    if (aCovers != bCovers)
+        return aCovers;
+    return aCovers ? a.scale < b.scale : a.scale > b.scale;
+}
+
+} // namespace
+
+/*!
+   \qmltype AssetResolver
+   \inqmlmodule QmlScreenExtras
+   \brief Picks the variant of an image that fits the screen of the window
+
+   The folder at root is read once, and only once per process no matter how many
+   AssetResolvers use it. Every file in it is put into an index under its name without
+   the variant parts:
+
+   \list
+   \li \c{@2x}, \c{@3x}, ... before the file extension, \c{icons/home@2x.png} is
+       \c{icons/home.png} at a scale of 2
+   \li Android density folders, \c{xhdpi/icons/home.png} or \c{drawable-xxhdpi/icons/home.png}
+   \li form factor folders, \c{phone/icons/home.png} is only used on phones
+   \endlist
+
+   For the device pixel ratio and form factor of the screen of the window, or the Android
+   density bucket on Android, the best variant of every name is worked out once. resolve()
+   is a hash lookup after that and never looks at the file system. The best variant is
+   the one for the form factor, then the one with the smallest scale that is not smaller
+   than the screen's.
+
+     \code
+     AssetResolver {
+        id: assets
+        root: "qrc:/images"
+     }
+     Image {
+        source: assets.resolve("icons/home.png", assets.revision)
+     }
+     \endcode
+
+   revision goes up whenever the variants were picked again, because the window moved to
+   another screen or the screen changed. Passing it to resolve() makes the binding follow it.
+   A name without any variant resolves to root and the name.
+*/
+
+AssetResolver::AssetResolver(QObject *parent) :
+    QObject(parent),
+    m_scale(0.0),
+    m_formFactor(-1),
+    m_revision(0),
+    m_complete(false)
+{
+}
+
+/*!
+ \qmlproperty url AssetResolver::root
+    The folder, or qrc path, with the assets.
+ */
+QUrl AssetResolver::root() const
+{
+    return m_root;
+}
+
+void AssetResolver::setRoot(const QUrl &root)
+{
+    if (m_root == root)
+        return;
+    m_root = root;
+
+    if (m_complete)
+    {
+        m_index = indexFor(m_root);
+        resolveAll();
+    }
+    emit rootChanged();
+}
+
+/*!
+ \qmlproperty int AssetResolver::revision
+    Goes up every time the variants are picked again.
+ */
+int AssetResolver::revision() const
+{
+    return m_revision;
+}
+
+/*!
+ \qmlproperty int AssetResolver::count
+    The number of assets, not counting their variants.
+ */
+int AssetResolver::count() const
+{
+    return m_resolved.size();
+}
+
+/*!
+ \qmlmethod url AssetResolver::resolve(string name, int revision)
+    The url of the variant of \a name that fits the screen best. \a revision is not
+    used, pass AssetResolver::revision to have the binding updated when it changes.
+ */
+QUrl AssetResolver::resolve(const QString &name, int revision) const
+{
+    Q_UNUSED(revision)
+
+    const QHash<QString, QUrl>::const_iterator it = m_resolved.constFind(name);
+    if (it != m_resolved.constEnd())
+        return it.value();
+    return QUrl(joined(m_root, name));
+}
+
+void AssetResolver::classBegin()
+{
+}
+
+void AssetResolver::componentComplete()
+{
+    m_complete = true;
+    if (!m_root.isEmpty())
+        m_index = indexFor(m_root);
+
+    if (QQuickItem *item = qobject_cast<QQuickItem *>(parent()))
+    {
+        connect(item, &QQuickItem::windowChanged,
+                this, &AssetResolver::onWindowChanged);
+        setWindow(item->window());
+    }
+    else
+    {
+        setWindow(qobject_cast<QWindow *>(parent()));
+    }
+}
+
+void AssetResolver::onWindowChanged(QQuickWindow *window)
+{
+    setWindow(window);
+}
+
+void AssetResolver::setWindow(QWindow *window)
+{
+    if (m_tracker)
+        disconnect(m_tracker, 0, this, 0);
+
+    m_tracker = WindowScreenTracker::forWindow(window);
+    connect(m_tracker, &WindowScreenTracker::changed,
+            this, &AssetResolver::updateResolved);
+    updateResolved();
+}
+
+// only picks again when the screen changed in a way that matters for the variants
+void AssetResolver::updateResolved()
+{
+    if (!m_tracker)
+        return;
+
+    const ScreenProfile &profile = m_tracker->profile();
+    double scale = densityScale(profile.androidDpi);
+    if (scale <= 0.0)
+        scale = m_tracker->devicePixelRatio();
+
+    if (scale == m_scale && int(profile.type) == m_formFactor)
+        return;
+
+    m_scale = scale;
+    m_formFactor = profile.type;
+    resolveAll();
+}
+
+void AssetResolver::resolveAll()
+{
+    m_resolved.clear();
+
+    if (m_index)
+    {
+        m_resolved.reserve(m_index->variants.size());
+
+        QHash<QString, QVector<AssetVariant> >::const_iterator it = m_index->variants.constBegin();
+        for (; it != m_index->variants.constEnd(); ++it)
+        {
+            const QVector<AssetVariant> &variants = it.value();
+            const AssetVariant *best = 0;
+            for (int i = 0; i < variants.size(); ++i)
+            {
+                const AssetVariant &variant = variants.at(i);
+                if (variant.formFactor >= 0 && variant.formFactor != m_formFactor)
+                    continue;
+                if (!best || isBetter(variant, *best, m_scale))
+                    best = &variant;
+            }
+
+            if (best)
+                m_resolved.insert(it.key(), QUrl(best->url));
+        }
+    }
+
+    ++m_revision;
+    emit revisionChanged();
+}
@@ -0,0 +1,89 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef ASSETRESOLVER_H
+#define ASSETRESOLVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QQmlParserStatus>
+#include <QSharedPointer>
+#include <QUrl>
+
+class QQuickWindow;
+class QWindow;
+class WindowScreenTracker;
+struct AssetIndex;
+
+// Picks the @2x, density or form factor variant of an asset for the screen of its window
+class AssetResolver : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY( QUrl root READ root WRITE setRoot NOTIFY rootChanged )
+    Q_PROPERTY( int revision READ revision NOTIFY revisionChanged )
+    Q_PROPERTY( int count READ count NOTIFY revisionChanged )
+
+public:
+    explicit AssetResolver( QObject *parent = 0 );
+
+    QUrl root() const;
+    void setRoot(const QUrl &root);
+
+    int revision() const;
+    int count() const;
+
+    // the revision is only there so that bindings are evaluated again when it changes
+    Q_INVOKABLE QUrl resolve(const QString &name, int revision = 0) const;
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void rootChanged();
+    void revisionChanged();
+
+protected slots:
+    void onWindowChanged(QQuickWindow *window);
+    void updateResolved();
+
+private:
+    void setWindow(QWindow *window);
+    void resolveAll();
+
+    QUrl m_root;
+    QSharedPointer<const AssetIndex> m_index;
+    QPointer<WindowScreenTracker> m_tracker;
+
+    // name to best variant, rebuilt when the scale or form factor changes
+    QHash<QString, QUrl> m_resolved;
+    double m_scale;
+    int m_formFactor;
+    int m_revision;
+    bool m_complete;
+};
+
+#endif // ASSETRESOLVER_H
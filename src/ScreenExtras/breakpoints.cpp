@@ -0,0 +1,310 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "breakpoints.h"
+#include "windowscreen.h"
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <algorithm>
+
+/*!
+   \qmltype Breakpoints
+   \inqmlmodule QmlScreenExtras
+   \brief Named widths in grid units that only notify when one of them is crossed
+
+   A binding like \c{width > ScreenExtras.gu(100)} is evaluated again for every pixel
+   of a resize. Breakpoints follows the width in C++ instead and only changes current
+   when the width moves past one of the breakpoints, so resizing costs next to nothing
+   in QML.
+
+   Each breakpoint is the smallest width, in grid units of the screen of the window,
+   at which it is used. It can also be a map with a width per form factor and a
+   "default" for the rest.
+
+     \code
+     Item {
+        Breakpoints {
+            id: layout
+            breakpoints: ({
+                "compact": 0,
+                "medium": 60,
+                "wide": { "tablet": 80, "default": 100 }
+            })
+        }
+
+        Loader {
+            source: layout.current === "wide" ? "Wide.qml" : "Narrow.qml"
+        }
+        Sidebar {
+            visible: layout.active.medium
+        }
+     }
+     \endcode
+
+   Without a target the width of the window is followed, the window is found through
+   the item the Breakpoints is declared in.
+*/
+
+Breakpoints::Breakpoints(QObject *parent) :
+    QObject(parent),
+    m_hysteresis(1.0),
+    m_gridUnit(8),
+    m_currentIndex(-1),
+    m_complete(false)
+{
+}
+
+/*!
+ \qmlproperty object Breakpoints::breakpoints
+    The name and the smallest width in grid units of every breakpoint.
+ */
+QVariantMap Breakpoints::breakpoints() const
+{
+    return m_breakpoints;
+}
+
+void Breakpoints::setBreakpoints(const QVariantMap &breakpoints)
+{
+    if (m_breakpoints == breakpoints)
+        return;
+    m_breakpoints = breakpoints;
+    updateThresholds();
+    emit breakpointsChanged();
+}
+
+/*!
+ \qmlproperty double Breakpoints::hysteresis
+    How far, in grid units, the width has to move past a breakpoint before current
+    changes. This keeps a window that is resized right at a breakpoint from switching
+    back and forth. The default is 1, values below 0 are taken as 0.
+ */
+double Breakpoints::hysteresis() const
+{
+    return m_hysteresis;
+}
+
+void Breakpoints::setHysteresis(double hysteresis)
+{
+    // a negative margin would switch before the breakpoint is reached
+    hysteresis = qMax(0.0, hysteresis);
+    if (m_hysteresis == hysteresis)
+        return;
+    m_hysteresis = hysteresis;
+    emit hysteresisChanged();
+
+    updateCurrent();
+}
+
+/*!
+ \qmlproperty Item Breakpoints::target
+    The item whose width is followed instead of the width of the window.
+ */
+QQuickItem *Breakpoints::target() const
+{
+    return m_target;
+}
+
+void Breakpoints::setTarget(QQuickItem *target)
+{
+    if (m_target == target)
+        return;
+
+    if (m_target)
+        disconnect(m_target, &QQuickItem::widthChanged, this, &Breakpoints::updateCurrent);
+    else if (m_window)
+        disconnect(m_window, &QWindow::widthChanged, this, &Breakpoints::updateCurrent);
+
+    m_target = target;
+
+    if (m_target)
+        connect(m_target, &QQuickItem::widthChanged, this, &Breakpoints::updateCurrent);
+    else if (m_window)
+        connect(m_window, &QWindow::widthChanged, this, &Breakpoints::updateCurrent);
+
+    // a new width, not a move of the old one
+    if (m_complete)
+        setCurrentIndex(indexFor(trackedWidth()));
+    emit targetChanged();
+}
+
+/*!
+ \qmlproperty string Breakpoints::current
+    The name of the widest breakpoint that fits, empty while none does.
+ */
+QString Breakpoints::current() const
+{
+    return m_current;
+}
+
+/*!
+ \qmlproperty int Breakpoints::currentIndex
+    The place of current when the breakpoints are sorted by width, -1 while none fits.
+ */
+int Breakpoints::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+/*!
+ \qmlproperty object Breakpoints::active
+    true for current and every narrower breakpoint, false for the wider ones.
+
+     \code
+     Sidebar { visible: layout.active.medium }
+     \endcode
+ */
+QVariantMap Breakpoints::active() const
+{
+    QVariantMap active;
+    for (int i = 0; i < m_thresholds.size(); ++i)
+        active.insert(m_thresholds.at(i).name, i <= m_currentIndex);
+    return active;
+}
+
+void Breakpoints::classBegin()
+{
+}
+
+void Breakpoints::componentComplete()
+{
+    m_complete = true;
+
+    m_parentItem = qobject_cast<QQuickItem *>(parent());
+    if (m_parentItem)
+    {
+        connect(m_parentItem, &QQuickItem::windowChanged,
+                this, &Breakpoints::onWindowChanged);
+        setWindow(m_parentItem->window());
+    }
+    else
+    {
+        setWindow(qobject_cast<QWindow *>(parent()));
+    }
+}
+
+void Breakpoints::onWindowChanged(QQuickWindow *window)
+{
+    setWindow(window);
+}
+
+void Breakpoints::setWindow(QWindow *window)
+{
+    if (m_window && !m_target)
+        disconnect(m_window, &QWindow::widthChanged, this, &Breakpoints::updateCurrent);
+    if (m_tracker)
+        disconnect(m_tracker, 0, this, 0);
+
+    m_window = window;
+    if (m_window && !m_target)
+        connect(m_window, &QWindow::widthChanged, this, &Breakpoints::updateCurrent);
+
+    m_tracker = WindowScreenTracker::forWindow(window);
+    connect(m_tracker, &WindowScreenTracker::changed,
+            this, &Breakpoints::updateThresholds);
+
+    updateThresholds();
+}
+
+// the breakpoints in px for the grid unit and form factor of the screen
+void Breakpoints::updateThresholds()
+{
+    QString formFactor;
+    if (m_tracker)
+    {
+        m_gridUnit = m_tracker->gridUnit();
+        formFactor = m_tracker->profile().formFactor;
+    }
+
+    m_thresholds.clear();
+    for (QVariantMap::const_iterator it = m_breakpoints.constBegin(); it != m_breakpoints.constEnd(); ++it)
+    {
+        QVariant value = it.value();
+        if (value.type() == QVariant::Map)
+        {
+            const QVariantMap perFormFactor = value.toMap();
+            value = perFormFactor.value(formFactor, perFormFactor.value(QStringLiteral("default")));
+        }
+
+        bool ok = false;
+        const double units = value.toDouble(&ok);
+        if (!ok)
+            continue;
+
+        Threshold threshold;
+        threshold.name = it.key();
+        threshold.width = units * m_gridUnit;
+        m_thresholds.append(threshold);
+    }
+
+    std::sort(m_thresholds.begin(), m_thresholds.end(),
+              [](const Threshold &a, const Threshold &b) { return a.width < b.width; });
+
+    if (m_complete)
+        setCurrentIndex(indexFor(trackedWidth()));
+}
+
+// Called for every step of a resize, so this stays in C++ unless a breakpoint is crossed
+void Breakpoints::updateCurrent()
+{
+    if (!m_complete)
+        return;
+
+    const double width = trackedWidth();
+    const double margin = m_hysteresis * m_gridUnit;
+
+    int index = m_currentIndex;
+    while (index + 1 < m_thresholds.size() && width >= m_thresholds.at(index + 1).width + margin)
+        ++index;
+    while (index >= 0 && width < m_thresholds.at(index).width - margin)
+        --index;
+
+    setCurrentIndex(index);
+}
+
+int Breakpoints::indexFor(double width) const
+{
+    int index = -1;
+    while (index + 1 < m_thresholds.size() && width >= m_thresholds.at(index + 1).width)
+        ++index;
+    return index;
+}
+
+double Breakpoints::trackedWidth() const
+{
+    if (m_target)
+        return m_target->width();
+    if (m_window)
+        return m_window->width();
+    return 0.0;
+}
+
+void Breakpoints::setCurrentIndex(int index)
+{
+    const QString current = index >= 0 ? m_thresholds.at(index).name : QString();
+    if (m_currentIndex == index && m_current == current)
+        return;
+    m_currentIndex = index;
+    m_current = current;
+    emit currentChanged();
+}
@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef BREAKPOINTS_H
+#define BREAKPOINTS_H
+
+#include <QObject>
+#include <QPointer>
+#include <QQmlParserStatus>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+class QQuickItem;
+class QQuickWindow;
+class QWindow;
+class WindowScreenTracker;
+
+// Named widths in grid units, only tells QML when the width crosses one
+class Breakpoints : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY( QVariantMap breakpoints READ breakpoints WRITE setBreakpoints NOTIFY breakpointsChanged )
+    Q_PROPERTY( double hysteresis READ hysteresis WRITE setHysteresis NOTIFY hysteresisChanged )
+    Q_PROPERTY( QQuickItem *target READ target WRITE setTarget NOTIFY targetChanged )
+    Q_PROPERTY( QString current READ current NOTIFY currentChanged )
+    Q_PROPERTY( int currentIndex READ currentIndex NOTIFY currentChanged )
+    Q_PROPERTY( QVariantMap active READ active NOTIFY currentChanged )
+
+public:
+    explicit Breakpoints( QObject *parent = 0 );
+
+    QVariantMap breakpoints() const;
+    void setBreakpoints(const QVariantMap &breakpoints);
+
+    double hysteresis() const;
+    void setHysteresis(double hysteresis);
+
+    QQuickItem *target() const;
+    void setTarget(QQuickItem *target);
+
+    QString current() const;
+    int currentIndex() const;
+    QVariantMap active() const;
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void breakpointsChanged();
+    void hysteresisChanged();
+    void targetChanged();
+    void currentChanged();
+
+protected slots:
+    void onWindowChanged(QQuickWindow *window);
+    void updateThresholds();
+    void updateCurrent();
+
+private:
+    struct Threshold
+    {
+        QString name;
+        double width;   // px
+    };
+
+    void setWindow(QWindow *window);
+    double trackedWidth() const;
+    void setCurrentIndex(int index);
+    int indexFor(double width) const;
+
+    QVariantMap m_breakpoints;
+    double m_hysteresis;
+    QPointer<QQuickItem> m_target;
+    QPointer<QQuickItem> m_parentItem;
+    QPointer<QWindow> m_window;
+    QPointer<WindowScreenTracker> m_tracker;
+
+    // ascending by width
+    QVector<Threshold> m_thresholds;
+    double m_gridUnit;
+    int m_currentIndex;
+    QString m_current;
+    bool m_complete;
+};
+
+#endif // BREAKPOINTS_H
@@ -0,0 +1,318 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "componentpreloader.h"
+#include "screenextrascore.h"
+#include "screentimings.h"
+#include <QFileSelector>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQmlFileSelector>
+
+namespace {
+
+// smallest to largest, the neighbours of a form factor are the ones next to it
+const FormFactorRules::Type bySize[] =
+{
+    FormFactorRules::Phone,
+    FormFactorRules::Phablet,
+    FormFactorRules::Tablet,
+    FormFactorRules::Desktop,
+    FormFactorRules::Tv
+};
+
+enum { FormFactorsBySize = sizeof(bySize) / sizeof(bySize[0]) };
+
+QStringList neighbours(FormFactorRules::Type type)
+{
+    QStringList names;
+    for (int i = 0; i < FormFactorsBySize; ++i)
+    {
+        if (bySize[i] != type)
+            continue;
+        if (i > 0)
+            names << FormFactorRules::typeName(bySize[i - 1]);
+        if (i + 1 < FormFactorsBySize)
+            names << FormFactorRules::typeName(bySize[i + 1]);
+    }
+    return names;
+}
+
+// the selectors this class sets, every other extra selector is left alone
+bool isScreenSelector(const QString &selector)
+{
+    for (int i = 0; i < FormFactorRules::TypeCount; ++i)
+    {
+        if (selector == FormFactorRules::typeName(static_cast<FormFactorRules::Type>(i)))
+            return true;
+    }
+    for (int i = 0; i < FormFactorRules::OperatingSystemCount; ++i)
+    {
+        if (selector == FormFactorRules::systemTypeName(static_cast<FormFactorRules::OperatingSystem>(i)))
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/*!
+   \qmltype ComponentPreloader
+   \inqmlmodule QmlScreenExtras
+   \brief Compiles the QML files of the form factor, and the ones next to it, in the background
+
+   Apps that load a different tree for phones, tablets and desktops usually keep the
+   variants in file selector folders, \c{+phone/Main.qml} next to \c{Main.qml}, and load
+   them with a Loader. The first time a Loader gets to a file it is compiled on the GUI
+   thread, which is a visible hitch when the window is rotated or resized into another
+   form factor.
+
+   ComponentPreloader sets the form factor and the operating system of ScreenExtras as
+   extra selectors on the QQmlFileSelector of the engine, so \c{+phone}, \c{+tablet},
+   \c{+android} and so on are picked by every url the engine loads. It then compiles the
+   selected variant of each of sources with QQmlComponent::Asynchronous. Once those are
+   ready the variants of the form factors next to the current one are compiled as well,
+   for a phone that is phablet, for a tablet phablet and desktop.
+
+     \code
+     ComponentPreloader {
+        sources: [ "Main.qml", "Settings.qml" ]
+     }
+     Loader {
+        source: "Main.qml"
+     }
+     \endcode
+
+   A Loader finds the compiled component in the cache of the engine then. When the form
+   factor changes the selectors follow and the new variants are compiled. From C++ the
+   same can be started before the first QML file is loaded
+
+     \code
+     ComponentPreloader::preload(&engine, QList<QUrl>() << QUrl("qrc:/Main.qml"));
+     \endcode
+*/
+
+ComponentPreloader::ComponentPreloader(QObject *parent) :
+    QObject(parent),
+    m_core(ScreenExtrasCore::instance()),
+    m_preloadNeighbours(true),
+    m_complete(false),
+    m_ready(false)
+{
+    connect(m_core.data(), &ScreenExtrasCore::formFactorChanged,
+            this, &ComponentPreloader::start);
+}
+
+ComponentPreloader *ComponentPreloader::preload(QQmlEngine *engine, const QList<QUrl> &sources)
+{
+    ComponentPreloader *preloader = new ComponentPreloader(engine);
+    preloader->m_engine = engine;
+    preloader->m_sources = sources;
+    preloader->m_complete = true;
+    preloader->start();
+    return preloader;
+}
+
+/*!
+ \qmlproperty list<url> ComponentPreloader::sources
+    The QML files to compile, relative to the file the ComponentPreloader is in. Use the
+    url without a selector folder, "Main.qml" and not "+phone/Main.qml".
+ */
+QList<QUrl> ComponentPreloader::sources() const
+{
+    return m_sources;
+}
+
+void ComponentPreloader::setSources(const QList<QUrl> &sources)
+{
+    if (m_sources == sources)
+        return;
+    m_sources = sources;
+
+    if (m_complete)
+        start();
+    emit sourcesChanged();
+}
+
+/*!
+ \qmlproperty bool ComponentPreloader::preloadNeighbours
+    Whether the variants of the form factors next to the current one are compiled too,
+    true by default.
+ */
+bool ComponentPreloader::preloadNeighbours() const
+{
+    return m_preloadNeighbours;
+}
+
+void ComponentPreloader::setPreloadNeighbours(bool preload)
+{
+    if (m_preloadNeighbours == preload)
+        return;
+    m_preloadNeighbours = preload;
+
+    if (m_complete && m_ready)
+        start();
+    emit preloadNeighboursChanged();
+}
+
+/*!
+ \qmlproperty list<string> ComponentPreloader::selectors
+    The form factor and operating system that are set as extra file selectors.
+ */
+QStringList ComponentPreloader::selectors() const
+{
+    return m_selectors;
+}
+
+/*!
+ \qmlproperty bool ComponentPreloader::ready
+    True once the variants for the current form factor are compiled.
+ */
+bool ComponentPreloader::ready() const
+{
+    return m_ready;
+}
+
+void ComponentPreloader::classBegin()
+{
+}
+
+void ComponentPreloader::componentComplete()
+{
+    m_complete = true;
+    m_engine = qmlEngine(this);
+    start();
+}
+
+void ComponentPreloader::start()
+{
+    if (!m_complete || !m_engine)
+        return;
+
+    m_resolvedSources.clear();
+    QQmlContext *context = qmlContext(this);
+    foreach (const QUrl &source, m_sources)
+        m_resolvedSources << (context ? context->resolvedUrl(source) : source);
+
+    const FormFactorRules::Type type = m_core->formFactorType();
+    const QString systemType = FormFactorRules::systemTypeName(FormFactorRules::currentOs());
+    updateSelectors(m_core->formFactor(), systemType);
+
+    m_pending.clear();
+    setReady(false);
+
+    // exactly the url a Loader of this engine is going to ask for
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    compile(*QQmlFileSelector::get(m_engine)->selector(), true);
+#else
+    QFileSelector current;
+    current.setExtraSelectors(m_selectors);
+    compile(current, true);
+#endif
+
+    if (m_pending.isEmpty())
+        setReady(true);
+
+    // what a rotation or a resize could switch to next
+    if (m_ready && m_preloadNeighbours)
+    {
+        foreach (const QString &formFactor, neighbours(type))
+        {
+            QFileSelector neighbour;
+            neighbour.setExtraSelectors(m_appSelectors + (QStringList() << formFactor << systemType));
+            compile(neighbour, false);
+        }
+    }
+}
+
+void ComponentPreloader::updateSelectors(const QString &formFactor, const QString &systemType)
+{
+    QQmlFileSelector *fileSelector = QQmlFileSelector::get(m_engine);
+    if (!fileSelector)
+        fileSelector = new QQmlFileSelector(m_engine, m_engine);
+
+    // the app can change its own selectors at any time, they are picked up again every time
+    QStringList appSelectors;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    foreach (const QString &selector, fileSelector->selector()->extraSelectors())
+    {
+        if (!isScreenSelector(selector))
+            appSelectors << selector;
+    }
+#endif
+
+    const QStringList selectors = QStringList() << formFactor << systemType;
+    if (m_selectors == selectors && m_appSelectors == appSelectors)
+        return;
+
+    const bool changed = m_selectors != selectors;
+    m_selectors = selectors;
+    m_appSelectors = appSelectors;
+    fileSelector->setExtraSelectors(appSelectors + selectors);
+
+    if (changed)
+        emit selectorsChanged();
+}
+
+void ComponentPreloader::compile(const QFileSelector &selector, bool current)
+{
+    foreach (const QUrl &source, m_resolvedSources)
+    {
+        const QUrl selected = selector.select(source);
+
+        QQmlComponent *component = m_components.value(selected);
+        if (!component)
+        {
+            component = new QQmlComponent(m_engine, selected, QQmlComponent::Asynchronous, this);
+            m_components.insert(selected, component);
+            connect(component, &QQmlComponent::statusChanged,
+                    this, &ComponentPreloader::onStatusChanged);
+        }
+
+        if (current && component->isLoading())
+            m_pending << component;
+    }
+}
+
+void ComponentPreloader::onStatusChanged()
+{
+    QQmlComponent *component = qobject_cast<QQmlComponent *>(sender());
+    if (!component || component->isLoading())
+        return;
+
+    if (component->isError())
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: can not preload" << component->url() << component->errorString();
+
+    if (m_pending.removeAll(component) > 0 && m_pending.isEmpty())
+        start();
+}
+
+void ComponentPreloader::setReady(bool ready)
+{
+    if (m_ready == ready)
+        return;
+    m_ready = ready;
+    emit readyChanged();
+}
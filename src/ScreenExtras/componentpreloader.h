@@ -0,0 +1,103 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef COMPONENTPRELOADER_H
+#define COMPONENTPRELOADER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQmlParserStatus>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QUrl>
+
+class QFileSelector;
+class QQmlComponent;
+class QQmlEngine;
+class ScreenExtrasCore;
+
+// Compiles the form factor variants of QML files before a Loader asks for them
+class ComponentPreloader : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY( QList<QUrl> sources READ sources WRITE setSources NOTIFY sourcesChanged )
+    Q_PROPERTY( bool preloadNeighbours READ preloadNeighbours WRITE setPreloadNeighbours NOTIFY preloadNeighboursChanged )
+    Q_PROPERTY( QStringList selectors READ selectors NOTIFY selectorsChanged )
+    Q_PROPERTY( bool ready READ ready NOTIFY readyChanged )
+
+public:
+    explicit ComponentPreloader( QObject *parent = 0 );
+
+    // for C++, before the first QML file is loaded
+    static ComponentPreloader *preload(QQmlEngine *engine, const QList<QUrl> &sources);
+
+    QList<QUrl> sources() const;
+    void setSources(const QList<QUrl> &sources);
+
+    bool preloadNeighbours() const;
+    void setPreloadNeighbours(bool preload);
+
+    QStringList selectors() const;
+    bool ready() const;
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void sourcesChanged();
+    void preloadNeighboursChanged();
+    void selectorsChanged();
+    void readyChanged();
+
+protected slots:
+    void start();
+    void onStatusChanged();
+
+private:
+    void updateSelectors(const QString &formFactor, const QString &systemType);
+    void compile(const QFileSelector &selector, bool current);
+    void setReady(bool ready);
+
+    QSharedPointer<ScreenExtrasCore> m_core;
+    QPointer<QQmlEngine> m_engine;
+    QList<QUrl> m_sources;
+    QList<QUrl> m_resolvedSources;
+    bool m_preloadNeighbours;
+    bool m_complete;
+    bool m_ready;
+    QStringList m_selectors;
+    // the other extra selectors of the engine, in front of ours
+    QStringList m_appSelectors;
+
+    // every variant that was compiled, by its selected url
+    QHash<QUrl, QQmlComponent *> m_components;
+    // the variants of the current form factor that are still compiling
+    QList<QQmlComponent *> m_pending;
+};
+
+#endif // COMPONENTPRELOADER_H
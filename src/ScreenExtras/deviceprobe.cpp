@@ -0,0 +1,318 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "deviceprobe.h"
+#include "screentimings.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQuickWindow>
+#include <QScreen>
+#include <QSysInfo>
+#include <QThread>
+
+#if defined(Q_OS_WIN)
+#  include <qt_windows.h>
+#elif defined(Q_OS_DARWIN)
+#  include <sys/types.h>
+#  include <sys/sysctl.h>
+#endif
+
+namespace {
+
+const char *const tierNames[] =
+{
+    "low",
+    "medium",
+    "high"
+};
+
+bool tierFromName(const QString &name, DeviceCapabilities::Tier *tier)
+{
+    for (int i = DeviceCapabilities::LowTier; i <= DeviceCapabilities::HighTier; ++i)
+    {
+        if (name == QLatin1String(tierNames[i]))
+        {
+            *tier = static_cast<DeviceCapabilities::Tier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+qint64 detectTotalMemoryMB()
+{
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return qint64(status.ullTotalPhys / (1024 * 1024));
+#elif defined(Q_OS_DARWIN)
+    quint64 bytes = 0;
+    size_t size = sizeof(bytes);
+    if (sysctlbyname("hw.memsize", &bytes, &size, 0, 0) == 0)
+        return qint64(bytes / (1024 * 1024));
+#elif defined(Q_OS_LINUX)
+    // Android included
+    QFile meminfo(QStringLiteral("/proc/meminfo"));
+    if (meminfo.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        while (!meminfo.atEnd())
+        {
+            const QByteArray line = meminfo.readLine();
+            if (line.startsWith("MemTotal:"))
+                return line.mid(9).trimmed().split(' ').value(0).toLongLong() / 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+QString detectGraphicsBackend()
+{
+    QString backend;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    backend = QQuickWindow::sceneGraphBackend();
+#endif
+    if (backend.isEmpty())
+        backend = QString::fromLocal8Bit(qgetenv("QMLSCENE_DEVICE"));
+
+    if (backend == QLatin1String("softwarecontext"))
+        return QStringLiteral("software");
+    if (!backend.isEmpty())
+        return backend;
+
+    // OpenGL drawn by the CPU is no better than the software backend
+    if (QCoreApplication::testAttribute(Qt::AA_UseSoftwareOpenGL)
+            || qgetenv("QT_OPENGL") == "software"
+            || qEnvironmentVariableIntValue("LIBGL_ALWAYS_SOFTWARE"))
+        return QStringLiteral("software");
+
+    return QStringLiteral("opengl");
+}
+
+// The parts that do not depend on the screen
+struct SystemCapabilities
+{
+    SystemCapabilities() :
+        cpuCores(QThread::idealThreadCount()),
+        cpuArchitecture(QSysInfo::buildCpuArchitecture()),
+        totalMemoryMB(detectTotalMemoryMB()),
+        graphicsBackend(detectGraphicsBackend())
+    {
+    }
+
+    int cpuCores;
+    QString cpuArchitecture;
+    qint64 totalMemoryMB;
+    QString graphicsBackend;
+};
+
+const SystemCapabilities &systemCapabilities()
+{
+    static const SystemCapabilities capabilities;
+    return capabilities;
+}
+
+struct Overrides
+{
+    Overrides() :
+        hasTier(false),
+        tier(DeviceCapabilities::MediumTier)
+    {
+        const QString fromEnvironment = QString::fromLocal8Bit(qgetenv("QMLSCREENEXTRAS_PERFORMANCE_TIER"));
+        if (fromEnvironment.isEmpty())
+            return;
+
+        if (tierFromName(fromEnvironment, &tier))
+        {
+            hasTier = true;
+            return;
+        }
+        read(fromEnvironment);
+    }
+
+    void read(const QString &fileName);
+
+    bool hasTier;
+    DeviceCapabilities::Tier tier;
+    QJsonObject values;
+};
+
+void Overrides::read(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: can not open performance tier overrides" << fileName;
+        return;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: performance tier overrides" << fileName << error.errorString();
+        return;
+    }
+
+    values = document.object();
+    if (values.contains(QStringLiteral("tier")))
+    {
+        hasTier = tierFromName(values.value(QStringLiteral("tier")).toString(), &tier);
+        if (!hasTier)
+            qCWarning(lcScreenExtras) << "QmlScreenExtras: unknown performance tier" << values.value(QStringLiteral("tier"));
+    }
+}
+
+const Overrides &overrides()
+{
+    static const Overrides fromEnvironment;
+    return fromEnvironment;
+}
+
+} // namespace
+
+DeviceCapabilities::DeviceCapabilities() :
+    cpuCores(1),
+    totalMemoryMB(0),
+    pixelWidth(0),
+    pixelHeight(0),
+    refreshRate(60.0),
+    hasTierOverride(false),
+    tierOverride(MediumTier)
+{
+}
+
+bool DeviceCapabilities::softwareRendering() const
+{
+    return graphicsBackend == QLatin1String("software");
+}
+
+double DeviceCapabilities::megapixelsPerSecond() const
+{
+    return double(pixelWidth) * pixelHeight * refreshRate / 1000000.0;
+}
+
+/*
+  The cores and the memory count for up to two points each, memory that
+  could not be read for none. 32 bit builds and a pixel load of 4K at 60Hz
+  lose one. Nothing that draws without a GPU gets past the low tier.
+
+  With three points for high, a 64 bit desktop with 4 cores and 8 GB at
+  1080p or 1440p and a phone with 8 cores and 4 GB end up there, 4 cores
+  with 4 GB or 2 cores with 8 GB in medium and anything smaller in low.
+*/
+DeviceCapabilities::Tier DeviceCapabilities::tier() const
+{
+    if (hasTierOverride)
+        return tierOverride;
+    if (softwareRendering())
+        return LowTier;
+
+    int score = 0;
+
+    if (cpuCores >= 8)
+        score += 2;
+    else if (cpuCores >= 4)
+        score += 1;
+
+    if (totalMemoryMB >= 7168)
+        score += 2;
+    else if (totalMemoryMB >= 3584)
+        score += 1;
+
+    if (!cpuArchitecture.contains(QLatin1String("64")))
+        score -= 1;
+
+    // 4K at 60Hz or 1440p at 120Hz is a lot of fill rate for any GPU
+    if (megapixelsPerSecond() >= 400.0)
+        score -= 1;
+
+    if (score >= 3)
+        return HighTier;
+    if (score >= 2)
+        return MediumTier;
+    return LowTier;
+}
+
+QVariantMap DeviceCapabilities::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("tier"), tierName(tier()));
+    map.insert(QStringLiteral("cpuCores"), cpuCores);
+    map.insert(QStringLiteral("cpuArchitecture"), cpuArchitecture);
+    map.insert(QStringLiteral("totalMemoryMB"), totalMemoryMB);
+    map.insert(QStringLiteral("graphicsBackend"), graphicsBackend);
+    map.insert(QStringLiteral("pixelWidth"), pixelWidth);
+    map.insert(QStringLiteral("pixelHeight"), pixelHeight);
+    map.insert(QStringLiteral("refreshRate"), refreshRate);
+    map.insert(QStringLiteral("megapixelsPerSecond"), megapixelsPerSecond());
+    return map;
+}
+
+QString DeviceCapabilities::tierName(Tier tier)
+{
+    return QLatin1String(tierNames[tier]);
+}
+
+DeviceCapabilities DeviceCapabilities::probe(QScreen *screen)
+{
+    ScreenTimingScope timing(ScreenTimings::DeviceProbe);
+
+    const SystemCapabilities &system = systemCapabilities();
+
+    DeviceCapabilities capabilities;
+    capabilities.cpuCores = system.cpuCores;
+    capabilities.cpuArchitecture = system.cpuArchitecture;
+    capabilities.totalMemoryMB = system.totalMemoryMB;
+    capabilities.graphicsBackend = system.graphicsBackend;
+
+    if (screen)
+    {
+        const QSize size = screen->size() * screen->devicePixelRatio();
+        capabilities.pixelWidth = size.width();
+        capabilities.pixelHeight = size.height();
+        if (screen->refreshRate() > 0.0)
+            capabilities.refreshRate = screen->refreshRate();
+    }
+
+    const Overrides &replaced = overrides();
+    const QJsonObject &values = replaced.values;
+    if (values.contains(QStringLiteral("cpuCores")))
+        capabilities.cpuCores = values.value(QStringLiteral("cpuCores")).toInt(capabilities.cpuCores);
+    if (values.contains(QStringLiteral("cpuArchitecture")))
+        capabilities.cpuArchitecture = values.value(QStringLiteral("cpuArchitecture")).toString();
+    if (values.contains(QStringLiteral("totalMemoryMB")))
+        capabilities.totalMemoryMB = qint64(values.value(QStringLiteral("totalMemoryMB")).toDouble());
+    if (values.contains(QStringLiteral("graphicsBackend")))
+        capabilities.graphicsBackend = values.value(QStringLiteral("graphicsBackend")).toString();
+    if (values.contains(QStringLiteral("refreshRate")))
+        capabilities.refreshRate = values.value(QStringLiteral("refreshRate")).toDouble(capabilities.refreshRate);
+
+    capabilities.hasTierOverride = replaced.hasTier;
+    capabilities.tierOverride = replaced.tier;
+    return capabilities;
+}
@@ -0,0 +1,86 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef DEVICEPROBE_H
+#define DEVICEPROBE_H
+
+#include <QString>
+#include <QVariantMap>
+
+class QScreen;
+
+/*
+  What the device can afford to draw, as opposed to the form factor which is
+  only about the size of the screen. The CPU, memory and scene graph backend
+  are probed once per process, the pixel load and refresh rate per screen.
+
+  QMLSCREENEXTRAS_PERFORMANCE_TIER is either a tier name ("low", "medium",
+  "high") or the path of a JSON file that can set the tier or replace any of
+  the probed values before the tier is worked out
+
+  {
+      "tier": "medium",
+      "cpuCores": 4,
+      "totalMemoryMB": 2048,
+      "graphicsBackend": "software"
+  }
+*/
+struct DeviceCapabilities
+{
+    enum Tier
+    {
+        LowTier,
+        MediumTier,
+        HighTier
+    };
+
+    DeviceCapabilities();
+
+    int cpuCores;
+    QString cpuArchitecture;
+    // 0 when the platform does not tell
+    qint64 totalMemoryMB;
+    // "opengl", "software", or the name of another Qt Quick backend
+    QString graphicsBackend;
+
+    int pixelWidth;
+    int pixelHeight;
+    double refreshRate;
+
+    // set by the override file, otherwise worked out from the values above
+    bool hasTierOverride;
+    Tier tierOverride;
+
+    bool softwareRendering() const;
+    // device pixels drawn per second at the full refresh rate, in millions
+    double megapixelsPerSecond() const;
+
+    Tier tier() const;
+    QVariantMap toVariantMap() const;
+
+    static QString tierName(Tier tier);
+    static DeviceCapabilities probe(QScreen *screen);
+};
+
+#endif // DEVICEPROBE_H
@@ -0,0 +1,299 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "formfactor.h"
+#include "screentimings.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QReadWriteLock>
+#include <QSysInfo>
+#include <QVector>
+#include <limits>
+
+namespace FormFactorRules
+{
+
+namespace
+{
+
+constexpr double Largest = std::numeric_limits<double>::infinity();
+
+// The diagonal thresholds in inches are the same for every operating system
+constexpr Rule defaultRules[] =
+{
+    { 3.5, 5, Phone },
+    { 5, 6.5, Phablet },
+    { 6.5, 10.1, Tablet },
+    // FIXME TV on windows
+    { 10.1, Largest, Desktop }
+};
+
+// Where an operating system differs, checked before defaultRules
+struct OsRule
+{
+    OperatingSystem os;
+    Rule rule;
+};
+
+constexpr OsRule osRules[] =
+{
+    // apple TV and android TV
+    { Ios, { 10.1, Largest, Tv } },
+    { Android, { 10.1, Largest, Tv } }
+};
+
+// smaller than a phone
+constexpr Type Fallback = Desktop;
+
+const char *const typeNames[TypeCount] =
+{
+    "desktop",
+    "tv",
+    "phablet",
+    "tablet",
+    "phone"
+};
+
+const char *const systemTypeNames[OperatingSystemCount] =
+{
+    "",
+    "ios",
+    "android",
+    "windows",
+    "winphone",
+    "osx",
+    "linux"
+};
+
+inline bool matches(const Rule &rule, double diagonal)
+{
+    return diagonal >= rule.minDiagonal && diagonal < rule.maxDiagonal;
+}
+
+struct UserRules
+{
+    UserRules()
+    {
+        const QString fileName = QString::fromLocal8Bit(qgetenv("QMLSCREENEXTRAS_FORMFACTOR_RULES"));
+        if (!fileName.isEmpty())
+            read(fileName);
+    }
+
+    bool read(const QString &fileName);
+
+    QReadWriteLock lock;
+    QVector<Rule> perOs[OperatingSystemCount];
+    QVector<Rule> anyOs;
+};
+
+Q_GLOBAL_STATIC(UserRules, userRules)
+
+OperatingSystem osFromName(const QString &name, bool *ok)
+{
+    *ok = true;
+    for (int i = 0; i < OperatingSystemCount; ++i)
+    {
+        if (name == QLatin1String(systemTypeNames[i]))
+            return static_cast<OperatingSystem>(i);
+    }
+    *ok = false;
+    return UnknownOs;
+}
+
+bool UserRules::read(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: can not open form factor rules" << fileName;
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: form factor rules" << fileName << error.errorString();
+        return false;
+    }
+
+    QVector<Rule> readPerOs[OperatingSystemCount];
+    QVector<Rule> readAnyOs;
+
+    const QJsonArray rules = document.object().value(QStringLiteral("rules")).toArray();
+    foreach (const QJsonValue &value, rules)
+    {
+        const QJsonObject object = value.toObject();
+
+        bool typeOk = false;
+        Rule rule;
+        rule.minDiagonal = object.value(QStringLiteral("minDiagonal")).toDouble(0.0);
+        rule.maxDiagonal = object.value(QStringLiteral("maxDiagonal")).toDouble(Largest);
+        rule.type = typeFromName(object.value(QStringLiteral("formFactor")).toString(), &typeOk);
+        if (!typeOk)
+        {
+            qCWarning(lcScreenExtras) << "QmlScreenExtras: skipping form factor rule with unknown formFactor" << object;
+            continue;
+        }
+
+        const QString os = object.value(QStringLiteral("os")).toString(QStringLiteral("*"));
+        if (os == QLatin1String("*"))
+        {
+            readAnyOs.append(rule);
+            continue;
+        }
+
+        bool osOk = false;
+        const OperatingSystem system = osFromName(os, &osOk);
+        if (!osOk)
+        {
+            qCWarning(lcScreenExtras) << "QmlScreenExtras: skipping form factor rule with unknown os" << object;
+            continue;
+        }
+        readPerOs[system].append(rule);
+    }
+
+    QWriteLocker locker(&lock);
+    for (int i = 0; i < OperatingSystemCount; ++i)
+        perOs[i] = readPerOs[i];
+    anyOs = readAnyOs;
+    return true;
+}
+
+OperatingSystem detectOs()
+{
+    ScreenTimingScope timing(ScreenTimings::SystemInfo);
+
+    const QString productType = QSysInfo::productType();
+
+    if (productType == QLatin1String("ios"))
+        return Ios;
+    if (productType == QLatin1String("android"))
+        return Android;
+    if (productType == QLatin1String("winphone"))
+        return WinPhone;
+    if (productType == QLatin1String("winrt")
+            || productType == QLatin1String("wince")
+            || productType == QLatin1String("windows"))
+        return Windows;
+    if (productType == QLatin1String("osx")
+            || productType == QLatin1String("macos"))
+        return MacOs;
+    // SOMETIMES ANDROID COMES back as Linux
+    if (QSysInfo::kernelType() == QLatin1String("linux"))
+        return Linux;
+    return UnknownOs;
+}
+
+} // namespace
+
+// QSysInfo is only asked once per process
+OperatingSystem currentOs()
+{
+    static const OperatingSystem os = detectOs();
+    return os;
+}
+
+QString systemTypeName(OperatingSystem os)
+{
+    return QLatin1String(systemTypeNames[os]);
+}
+
+OperatingSystem systemTypeFromName(const QString &name, bool *ok)
+{
+    bool found = false;
+    const OperatingSystem os = osFromName(name, &found);
+    if (ok)
+        *ok = found;
+    return os;
+}
+
+Type typeFromName(const QString &name, bool *ok)
+{
+    for (int i = 0; i < TypeCount; ++i)
+    {
+        if (name == QLatin1String(typeNames[i]))
+        {
+            if (ok)
+                *ok = true;
+            return static_cast<Type>(i);
+        }
+    }
+    if (ok)
+        *ok = false;
+    return Desktop;
+}
+
+QString typeName(Type type)
+{
+    return QLatin1String(typeNames[type]);
+}
+
+Type classify(OperatingSystem os, double diagonal)
+{
+    UserRules *user = userRules();
+    {
+        QReadLocker locker(&user->lock);
+        foreach (const Rule &rule, user->perOs[os])
+        {
+            if (matches(rule, diagonal))
+                return rule.type;
+        }
+        foreach (const Rule &rule, user->anyOs)
+        {
+            if (matches(rule, diagonal))
+                return rule.type;
+        }
+    }
+
+    for (const OsRule &osRule : osRules)
+    {
+        if (osRule.os == os && matches(osRule.rule, diagonal))
+            return osRule.rule.type;
+    }
+    for (const Rule &rule : defaultRules)
+    {
+        if (matches(rule, diagonal))
+            return rule.type;
+    }
+    return Fallback;
+}
+
+bool load(const QString &fileName)
+{
+    return userRules()->read(fileName);
+}
+
+void clearUserRules()
+{
+    UserRules *user = userRules();
+    QWriteLocker locker(&user->lock);
+    for (int i = 0; i < OperatingSystemCount; ++i)
+        user->perOs[i].clear();
+    user->anyOs.clear();
+}
+
+} // namespace FormFactorRules
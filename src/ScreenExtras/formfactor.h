@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef FORMFACTOR_H
+#define FORMFACTOR_H
+
+#include <QString>
+
+/*
+  The table that maps the diagonal of a screen to a form factor.
+
+  The built in rules are fixed at compile time, one set of thresholds for
+  every operating system and an override where one differs. Extra rules
+  can be read from a JSON file, they are checked before the built in ones
+  for their operating system:
+
+  {
+      "rules": [
+          { "os": "linux", "minDiagonal": 10.1, "maxDiagonal": 16, "formFactor": "tablet" },
+          { "os": "*", "minDiagonal": 40, "formFactor": "tv" }
+      ]
+  }
+
+  The file is taken from QMLSCREENEXTRAS_FORMFACTOR_RULES or can be loaded
+  with FormFactorRules::load() before the first ScreenExtras is made.
+*/
+namespace FormFactorRules
+{
+
+enum OperatingSystem
+{
+    UnknownOs,
+    Ios,
+    Android,
+    Windows,
+    WinPhone,
+    MacOs,
+    Linux,
+    OperatingSystemCount
+};
+
+// same order as ScreenExtras::FormFactorType
+enum Type
+{
+    Desktop,
+    Tv,
+    Phablet,
+    Tablet,
+    Phone,
+    TypeCount
+};
+
+struct Rule
+{
+    double minDiagonal;   // inclusive
+    double maxDiagonal;   // exclusive
+    Type type;
+};
+
+OperatingSystem currentOs();
+QString systemTypeName(OperatingSystem os);
+OperatingSystem systemTypeFromName(const QString &name, bool *ok = 0);
+
+Type typeFromName(const QString &name, bool *ok = 0);
+QString typeName(Type type);
+
+Type classify(OperatingSystem os, double diagonal);
+
+bool load(const QString &fileName);
+void clearUserRules();
+
+} // namespace FormFactorRules
+
+#endif // FORMFACTOR_H
@@ -0,0 +1,403 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "framestatistics.h"
+#include "windowscreen.h"
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QScreen>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/*
+  Qt Quick only renders when something changed, so a long pause between two
+  frames is a window that had nothing to do rather than a slow frame.
+*/
+const float IdleInterval = 250.0f;
+
+// nearest rank, values is reordered
+double percentile(QVector<float> &values, double fraction)
+{
+    if (values.isEmpty())
+        return 0.0;
+
+    const int rank = qBound(0, int(std::ceil(fraction * values.size())) - 1, values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values.at(rank);
+}
+
+} // namespace
+
+/*!
+   \qmltype FrameStatistics
+   \inqmlmodule QmlScreenExtras
+   \brief Frame rate, frame times and missed frames of the window it is in
+
+   screenRefreshRateAt() tells how often the screen could show a new frame,
+   FrameStatistics tells how often the window actually delivered one. It measures the
+   time between two frameSwapped() of the window on the render thread and hands the
+   intervals to the GUI thread through a lock free ring buffer, so watching the frame
+   rate does not slow the render thread down.
+
+     \code
+     Window {
+        FrameStatistics {
+            id: frames
+            updateInterval: 1000
+        }
+        Text {
+            text: frames.fps.toFixed(1) + " fps, p99 " + frames.frameTime99.toFixed(1)
+                  + " ms, " + frames.missedFrames + " missed"
+        }
+     }
+     \endcode
+
+   The numbers are worked out again every updateInterval ms and only when frames were
+   drawn since, an idle window does not wake up QML. A pause of more than 250 ms between
+   two frames is taken as the window being idle and left out.
+*/
+
+FrameStatistics::FrameStatistics(QObject *parent) :
+    QObject(parent),
+    m_running(true),
+    m_complete(false),
+    m_sampleCount(120),
+    m_history(120, 0.0f),
+    m_historyNext(0),
+    m_historySize(0),
+    m_refreshRate(60.0),
+    m_fps(0.0),
+    m_frameTime50(0.0),
+    m_frameTime95(0.0),
+    m_frameTime99(0.0),
+    m_missedFrames(0),
+    m_frameCount(0)
+{
+    m_updateTimer.setInterval(500);
+    connect(&m_updateTimer, &QTimer::timeout,
+            this, &FrameStatistics::updateStatistics);
+}
+
+FrameStatistics::~FrameStatistics()
+{
+    disconnectWindow();
+}
+
+/*!
+ \qmlproperty bool FrameStatistics::running
+    Whether frames are measured, true by default.
+ */
+bool FrameStatistics::running() const
+{
+    return m_running;
+}
+
+void FrameStatistics::setRunning(bool running)
+{
+    if (m_running == running)
+        return;
+    m_running = running;
+
+    if (m_complete)
+    {
+        if (m_running)
+            connectWindow();
+        else
+            disconnectWindow();
+    }
+    emit runningChanged();
+}
+
+/*!
+ \qmlproperty int FrameStatistics::updateInterval
+    How often, in ms, the numbers are updated for QML. 500 by default.
+ */
+int FrameStatistics::updateInterval() const
+{
+    return m_updateTimer.interval();
+}
+
+void FrameStatistics::setUpdateInterval(int msecs)
+{
+    msecs = qMax(1, msecs);
+    if (m_updateTimer.interval() == msecs)
+        return;
+    m_updateTimer.setInterval(msecs);
+    emit updateIntervalChanged();
+}
+
+/*!
+ \qmlproperty int FrameStatistics::sampleCount
+    How many of the last frames fps and the frame times are worked out from, 120 by
+    default. Changing it starts over.
+ */
+int FrameStatistics::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+void FrameStatistics::setSampleCount(int count)
+{
+    count = qMax(1, count);
+    if (m_sampleCount == count)
+        return;
+    m_sampleCount = count;
+    m_history.fill(0.0f, count);
+    m_historyNext = 0;
+    m_historySize = 0;
+    emit sampleCountChanged();
+}
+
+/*!
+ \qmlproperty double FrameStatistics::refreshRate
+    The refresh rate of the screen the window is on, missed frames are counted against it.
+ */
+double FrameStatistics::refreshRate() const
+{
+    return m_refreshRate;
+}
+
+/*!
+ \qmlproperty double FrameStatistics::fps
+    Frames per second over the last sampleCount frames.
+ */
+double FrameStatistics::fps() const
+{
+    return m_fps;
+}
+
+/*!
+ \qmlproperty double FrameStatistics::frameTime50
+    The median time between two frames in ms over the last sampleCount frames.
+ */
+double FrameStatistics::frameTime50() const
+{
+    return m_frameTime50;
+}
+
+/*!
+ \qmlproperty double FrameStatistics::frameTime95
+    The 95th percentile of the time between two frames in ms.
+ */
+double FrameStatistics::frameTime95() const
+{
+    return m_frameTime95;
+}
+
+/*!
+ \qmlproperty double FrameStatistics::frameTime99
+    The 99th percentile of the time between two frames in ms, the frames that stutter.
+ */
+double FrameStatistics::frameTime99() const
+{
+    return m_frameTime99;
+}
+
+/*!
+ \qmlproperty int FrameStatistics::missedFrames
+    How many vsyncs went by without a new frame since the start or the last reset().
+    A frame that took two and a half refresh intervals counts as two missed ones.
+ */
+int FrameStatistics::missedFrames() const
+{
+    return m_missedFrames;
+}
+
+/*!
+ \qmlproperty int FrameStatistics::frameCount
+    How many frames were measured since the start or the last reset().
+ */
+int FrameStatistics::frameCount() const
+{
+    return m_frameCount;
+}
+
+/*!
+ \qmlmethod FrameStatistics::reset()
+    Forgets every frame measured so far.
+ */
+void FrameStatistics::reset()
+{
+    if (m_swaps)
+    {
+        m_swaps->restart.store(true);
+
+        float discarded[FrameIntervalBuffer::Capacity];
+        m_swaps->buffer.pop(discarded, FrameIntervalBuffer::Capacity);
+    }
+
+    m_historyNext = 0;
+    m_historySize = 0;
+    m_fps = 0.0;
+    m_frameTime50 = 0.0;
+    m_frameTime95 = 0.0;
+    m_frameTime99 = 0.0;
+    m_missedFrames = 0;
+    m_frameCount = 0;
+    emit statisticsChanged();
+}
+
+void FrameStatistics::classBegin()
+{
+}
+
+void FrameStatistics::componentComplete()
+{
+    m_complete = true;
+
+    if (QQuickItem *item = qobject_cast<QQuickItem *>(parent()))
+    {
+        connect(item, &QQuickItem::windowChanged,
+                this, &FrameStatistics::onWindowChanged);
+        setWindow(item->window());
+    }
+    else
+    {
+        setWindow(qobject_cast<QQuickWindow *>(parent()));
+    }
+}
+
+void FrameStatistics::onWindowChanged(QQuickWindow *window)
+{
+    setWindow(window);
+}
+
+void FrameStatistics::setWindow(QQuickWindow *window)
+{
+    disconnectWindow();
+    if (m_tracker)
+        disconnect(m_tracker, 0, this, 0);
+
+    m_window = window;
+    m_tracker = WindowScreenTracker::forWindow(window);
+    connect(m_tracker, &WindowScreenTracker::changed,
+            this, &FrameStatistics::onScreenChanged);
+    onScreenChanged();
+
+    if (m_running)
+        connectWindow();
+}
+
+void FrameStatistics::connectWindow()
+{
+    if (!m_window)
+        return;
+
+    // the first frame after this only starts the clock
+    std::shared_ptr<FrameSwapClock> swaps = std::make_shared<FrameSwapClock>();
+    m_swaps = swaps;
+    m_swapConnection = connect(m_window.data(), &QQuickWindow::frameSwapped, this,
+                               [swaps]() { swaps->swapped(); }, Qt::DirectConnection);
+    m_updateTimer.start();
+}
+
+void FrameStatistics::disconnectWindow()
+{
+    m_updateTimer.stop();
+    disconnect(m_swapConnection);
+    m_swaps.reset();
+}
+
+void FrameStatistics::onScreenChanged()
+{
+    QScreen *screen = m_tracker ? m_tracker->screen() : 0;
+    if (m_screen != screen)
+    {
+        if (m_screen)
+            disconnect(m_screen.data(), &QScreen::refreshRateChanged,
+                       this, &FrameStatistics::updateRefreshRate);
+        m_screen = screen;
+        // a mode switch changes the rate without changing the screen
+        if (m_screen)
+            connect(m_screen.data(), &QScreen::refreshRateChanged,
+                    this, &FrameStatistics::updateRefreshRate);
+    }
+    updateRefreshRate();
+}
+
+void FrameStatistics::updateRefreshRate()
+{
+    const double rate = m_screen && m_screen->refreshRate() > 0.0 ? m_screen->refreshRate() : 60.0;
+    if (m_refreshRate == rate)
+        return;
+    m_refreshRate = rate;
+    emit statisticsChanged();
+}
+
+// render thread, as cheap as it gets
+void FrameSwapClock::swapped()
+{
+    if (restart.exchange(false) || !clock.isValid())
+    {
+        clock.start();
+        lastSwap = 0;
+        return;
+    }
+
+    const qint64 now = clock.nsecsElapsed();
+    const float interval = float(now - lastSwap) / 1000000.0f;
+    lastSwap = now;
+
+    if (interval < IdleInterval)
+        buffer.push(interval);
+}
+
+void FrameStatistics::updateStatistics()
+{
+    if (!m_swaps)
+        return;
+
+    float intervals[FrameIntervalBuffer::Capacity];
+    const int count = m_swaps->buffer.pop(intervals, FrameIntervalBuffer::Capacity);
+    if (count == 0)
+        return;
+
+    const double refreshInterval = 1000.0 / m_refreshRate;
+    for (int i = 0; i < count; ++i)
+    {
+        m_history[m_historyNext] = intervals[i];
+        m_historyNext = (m_historyNext + 1) % m_sampleCount;
+        m_historySize = qMin(m_historySize + 1, m_sampleCount);
+
+        m_missedFrames += qMax(0, qRound(intervals[i] / refreshInterval) - 1);
+    }
+    m_frameCount += count;
+
+    m_scratch.resize(m_historySize);
+    double total = 0.0;
+    for (int i = 0; i < m_historySize; ++i)
+    {
+        m_scratch[i] = m_history.at(i);
+        total += m_history.at(i);
+    }
+
+    m_fps = total > 0.0 ? m_historySize * 1000.0 / total : 0.0;
+    m_frameTime50 = percentile(m_scratch, 0.50);
+    m_frameTime95 = percentile(m_scratch, 0.95);
+    m_frameTime99 = percentile(m_scratch, 0.99);
+
+    emit statisticsChanged();
+}
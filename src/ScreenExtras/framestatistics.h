@@ -0,0 +1,213 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef FRAMESTATISTICS_H
+#define FRAMESTATISTICS_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QQmlParserStatus>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+class QQuickWindow;
+class QScreen;
+class QWindow;
+class WindowScreenTracker;
+
+/*
+  Frame intervals from the render thread to the GUI thread. One thread
+  pushes and one pops, so the two indices are all the synchronization that
+  is needed. The storage is allocated up front and a full buffer drops the
+  new interval instead of blocking the render thread.
+*/
+class FrameIntervalBuffer
+{
+public:
+    // a power of two, over 8 seconds of frames at 60Hz
+    enum { Capacity = 512 };
+
+    FrameIntervalBuffer() :
+        m_head(0),
+        m_tail(0),
+        m_dropped(0)
+    {
+    }
+
+    // render thread
+    bool push(float interval)
+    {
+        const quint32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_intervals[head & (Capacity - 1)] = interval;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // GUI thread, returns how many intervals were written to out
+    int pop(float *out, int max)
+    {
+        const quint32 tail = m_tail.load(std::memory_order_relaxed);
+        const quint32 available = m_head.load(std::memory_order_acquire) - tail;
+        const int count = qMin(int(available), max);
+
+        for (int i = 0; i < count; ++i)
+            out[i] = m_intervals[(tail + i) & (Capacity - 1)];
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    quint32 dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    Q_DISABLE_COPY(FrameIntervalBuffer)
+
+    float m_intervals[Capacity];
+    std::atomic<quint32> m_head;
+    std::atomic<quint32> m_tail;
+    std::atomic<quint32> m_dropped;
+};
+
+/*
+  Everything the render thread touches. The connection to frameSwapped owns
+  a reference, so a call that is still running when the FrameStatistics goes
+  away or moves to another window keeps it alive until it returns.
+*/
+struct FrameSwapClock
+{
+    FrameSwapClock() :
+        lastSwap(0),
+        restart(true)
+    {
+    }
+
+    // render thread
+    void swapped();
+
+    QElapsedTimer clock;
+    qint64 lastSwap;
+    std::atomic<bool> restart;
+    FrameIntervalBuffer buffer;
+};
+
+// Frame times of the window it is in, measured against the refresh rate of its screen
+class FrameStatistics : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY( bool running READ running WRITE setRunning NOTIFY runningChanged )
+    Q_PROPERTY( int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged )
+    Q_PROPERTY( int sampleCount READ sampleCount WRITE setSampleCount NOTIFY sampleCountChanged )
+    Q_PROPERTY( double refreshRate READ refreshRate NOTIFY statisticsChanged )
+    Q_PROPERTY( double fps READ fps NOTIFY statisticsChanged )
+    Q_PROPERTY( double frameTime50 READ frameTime50 NOTIFY statisticsChanged )
+    Q_PROPERTY( double frameTime95 READ frameTime95 NOTIFY statisticsChanged )
+    Q_PROPERTY( double frameTime99 READ frameTime99 NOTIFY statisticsChanged )
+    Q_PROPERTY( int missedFrames READ missedFrames NOTIFY statisticsChanged )
+    Q_PROPERTY( int frameCount READ frameCount NOTIFY statisticsChanged )
+
+public:
+    explicit FrameStatistics( QObject *parent = 0 );
+    ~FrameStatistics();
+
+    bool running() const;
+    void setRunning(bool running);
+
+    int updateInterval() const;
+    void setUpdateInterval(int msecs);
+
+    int sampleCount() const;
+    void setSampleCount(int count);
+
+    double refreshRate() const;
+    double fps() const;
+    double frameTime50() const;
+    double frameTime95() const;
+    double frameTime99() const;
+    int missedFrames() const;
+    int frameCount() const;
+
+    Q_INVOKABLE void reset();
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void runningChanged();
+    void updateIntervalChanged();
+    void sampleCountChanged();
+    void statisticsChanged();
+
+protected slots:
+    void onWindowChanged(QQuickWindow *window);
+    void onScreenChanged();
+    void updateRefreshRate();
+    void updateStatistics();
+
+private:
+    void setWindow(QQuickWindow *window);
+    void connectWindow();
+    void disconnectWindow();
+
+    bool m_running;
+    bool m_complete;
+    int m_sampleCount;
+
+    QPointer<QQuickWindow> m_window;
+    QPointer<WindowScreenTracker> m_tracker;
+    QPointer<QScreen> m_screen;
+    QTimer m_updateTimer;
+
+    // a new one for every connection to a window
+    std::shared_ptr<FrameSwapClock> m_swaps;
+    QMetaObject::Connection m_swapConnection;
+
+    // rolling window of the last m_sampleCount intervals, in ms
+    QVector<float> m_history;
+    int m_historyNext;
+    int m_historySize;
+    QVector<float> m_scratch;
+
+    double m_refreshRate;
+    double m_fps;
+    double m_frameTime50;
+    double m_frameTime95;
+    double m_frameTime99;
+    int m_missedFrames;
+    int m_frameCount;
+};
+
+#endif // FRAMESTATISTICS_H
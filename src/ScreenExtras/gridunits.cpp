@@ -0,0 +1,78 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "gridunits.h"
+#include "screenprofile.h"
+
+/*!
+   \qmltype GridUnits
+   \inqmlmodule QmlScreenExtras
+   \brief Common grid unit sizes as properties, see ScreenExtras::units
+
+   ScreenExtras.gu() is a function, so a binding that calls it does not know that it
+   has to be evaluated again when the grid unit changes and every evaluation goes
+   through a call into C++. The properties here are worked out once when the grid unit
+   changes and bindings that read them are updated with it.
+
+     \code
+     Rectangle {
+        width: ScreenExtras.units.gu10
+        height: ScreenExtras.units.gridUnit * 7
+        radius: ScreenExtras.units.half
+     }
+     \endcode
+
+   Sizes that are not listed can be made with gridUnit, \c{units.gridUnit * 7} is
+   the same as \c{gu(7)}. dp is one eighth of a grid unit, the size of a pixel when the
+   scale is 1.
+*/
+
+namespace
+{
+const double multiples[] = { 2, 3, 4, 5, 6, 8, 10, 12, 16, 20 };
+}
+
+GridUnits::GridUnits(QObject *parent) :
+    QObject(parent),
+    m_gridUnit(0.0)
+{
+    setGridUnit(ScreenProfile::DefaultGridUnit);
+}
+
+bool GridUnits::setGridUnit(double gridUnit, bool notify)
+{
+    if (m_gridUnit == gridUnit)
+        return false;
+
+    m_gridUnit = gridUnit;
+    m_dp = gridUnit / ScreenProfile::DefaultGridUnit;
+    m_quarter = gridUnit * 0.25;
+    m_half = gridUnit * 0.5;
+    for (int i = 0; i < MultipleCount; ++i)
+        m_multiples[i] = gridUnit * multiples[i];
+
+    if (notify)
+        emit gridUnitChanged();
+    return true;
+}
@@ -0,0 +1,85 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef GRIDUNITS_H
+#define GRIDUNITS_H
+
+#include <QObject>
+
+// Grid unit multiples as properties so bindings depend on gridUnitChanged()
+class GridUnits : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY( double gridUnit READ gridUnit NOTIFY gridUnitChanged )
+    Q_PROPERTY( double dp READ dp NOTIFY gridUnitChanged )
+    Q_PROPERTY( double quarter READ quarter NOTIFY gridUnitChanged )
+    Q_PROPERTY( double half READ half NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu1 READ gu1 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu2 READ gu2 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu3 READ gu3 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu4 READ gu4 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu5 READ gu5 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu6 READ gu6 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu8 READ gu8 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu10 READ gu10 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu12 READ gu12 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu16 READ gu16 NOTIFY gridUnitChanged )
+    Q_PROPERTY( double gu20 READ gu20 NOTIFY gridUnitChanged )
+
+public:
+    explicit GridUnits( QObject *parent = 0 );
+
+    double gridUnit() const { return m_gridUnit; }
+    bool setGridUnit(double gridUnit, bool notify = true);
+
+    double dp() const { return m_dp; }
+    double quarter() const { return m_quarter; }
+    double half() const { return m_half; }
+    double gu1() const { return m_gridUnit; }
+    double gu2() const { return m_multiples[0]; }
+    double gu3() const { return m_multiples[1]; }
+    double gu4() const { return m_multiples[2]; }
+    double gu5() const { return m_multiples[3]; }
+    double gu6() const { return m_multiples[4]; }
+    double gu8() const { return m_multiples[5]; }
+    double gu10() const { return m_multiples[6]; }
+    double gu12() const { return m_multiples[7]; }
+    double gu16() const { return m_multiples[8]; }
+    double gu20() const { return m_multiples[9]; }
+
+signals:
+    void gridUnitChanged();
+
+private:
+    enum { MultipleCount = 10 };
+
+    double m_gridUnit;
+    double m_dp;
+    double m_quarter;
+    double m_half;
+    double m_multiples[MultipleCount];
+};
+
+#endif // GRIDUNITS_H
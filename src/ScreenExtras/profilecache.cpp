@@ -0,0 +1,439 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "profilecache.h"
+#include "screenprofile.h"
+#include "screenfonts.h"
+#include "screentimings.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QScreen>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+namespace ProfileCache
+{
+
+namespace
+{
+
+// bump this when detect() or the built in tables change what they return
+enum { FormatVersion = 1 };
+
+// unpinned entries above this are dropped, oldest first
+enum { MaxEntries = 32 };
+
+const char *const fontNames[FontTable::FontCount] =
+{
+    "",
+    "xxlarge",
+    "xlarge",
+    "large",
+    "medium",
+    "normal",
+    "small",
+    "tiny"
+};
+
+struct Entry
+{
+    QString key;
+    bool pinned;
+    ScreenProfile profile;
+};
+
+struct Cache
+{
+    Cache() :
+        loaded(false),
+        saving(false),
+        savePending(false)
+    {
+        const QString fromEnvironment = QString::fromLocal8Bit(qgetenv("QMLSCREENEXTRAS_PROFILE_CACHE"));
+        if (fromEnvironment.isEmpty()
+                || fromEnvironment == QLatin1String("0")
+                || fromEnvironment == QLatin1String("off"))
+        {
+            return;
+        }
+
+        if (fromEnvironment == QLatin1String("1") || fromEnvironment == QLatin1String("on"))
+            fileName = defaultFileName();
+        else
+            fileName = fromEnvironment;
+    }
+
+    static QString defaultFileName()
+    {
+        const QString location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (location.isEmpty())
+            return QString();
+        return location + QStringLiteral("/qmlscreenextras-profiles.json");
+    }
+
+    void load();
+    void scheduleSave();
+    void reindex();
+    const Entry *find(const QString &key) const;
+
+    QMutex mutex;
+    bool loaded;
+    QString fileName;
+    QVector<Entry> entries;
+    // a SaveJob is running, and it has to write entries once more
+    bool saving;
+    bool savePending;
+    QHash<QString, int> byKey;
+    // pinned entries with a "*" in the key, checked one by one
+    QVector<int> patterns;
+};
+
+Q_GLOBAL_STATIC(Cache, cache)
+
+bool matchesPattern(const QString &pattern, const QString &key)
+{
+    const QStringList patternParts = pattern.split(QLatin1Char('|'));
+    const QStringList keyParts = key.split(QLatin1Char('|'));
+    if (patternParts.size() != keyParts.size())
+        return false;
+
+    for (int i = 0; i < patternParts.size(); ++i)
+    {
+        if (patternParts.at(i) != QLatin1String("*") && patternParts.at(i) != keyParts.at(i))
+            return false;
+    }
+    return true;
+}
+
+bool profileFromJson(const QJsonObject &object, ScreenProfile *profile)
+{
+    bool osOk = false;
+    const FormFactorRules::OperatingSystem os =
+            FormFactorRules::systemTypeFromName(object.value(QStringLiteral("os")).toString(), &osOk);
+    bool typeOk = false;
+    const FormFactorRules::Type type =
+            FormFactorRules::typeFromName(object.value(QStringLiteral("formFactor")).toString(), &typeOk);
+    const double scaleSize = object.value(QStringLiteral("scaleSize")).toDouble(0.0);
+
+    if (!osOk || !typeOk || scaleSize <= 0.0)
+        return false;
+
+    profile->isValid = true;
+    profile->os = os;
+    profile->systemType = FormFactorRules::systemTypeName(os);
+    profile->type = type;
+    profile->formFactor = FormFactorRules::typeName(type);
+    profile->androidDpi = object.value(QStringLiteral("androidDpi")).toString();
+    profile->scaleSize = scaleSize;
+    profile->diagonal = object.value(QStringLiteral("diagonal")).toDouble(0.0);
+
+    // without fonts the sizes come from the font table as usual
+    profile->fontSizes.clear();
+    if (!object.value(QStringLiteral("pinned")).toBool(false))
+        return true;
+
+    const QJsonObject fonts = object.value(QStringLiteral("fonts")).toObject();
+    if (!fonts.isEmpty())
+    {
+        profile->fontSizes.fill(0.0, FontTable::FontCount);
+        for (int i = 1; i < FontTable::FontCount; ++i)
+            profile->fontSizes[i] = fonts.value(QLatin1String(fontNames[i])).toDouble(0.0);
+    }
+    return true;
+}
+
+// only pinned sizes are kept, the others follow the font table and the snapping
+QJsonObject profileToJson(const ScreenProfile &profile, bool pinned)
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("os"), profile.systemType);
+    object.insert(QStringLiteral("formFactor"), profile.formFactor);
+    object.insert(QStringLiteral("androidDpi"), profile.androidDpi);
+    object.insert(QStringLiteral("scaleSize"), profile.scaleSize);
+    object.insert(QStringLiteral("diagonal"), profile.diagonal);
+
+    if (pinned && profile.hasFontSizes())
+    {
+        QJsonObject fonts;
+        for (int i = 1; i < FontTable::FontCount; ++i)
+            fonts.insert(QLatin1String(fontNames[i]), profile.fontSizes.at(i));
+        object.insert(QStringLiteral("fonts"), fonts);
+    }
+    return object;
+}
+
+void writeFile(const QString &fileName, const QVector<Entry> &entries)
+{
+    QJsonArray profiles;
+    foreach (const Entry &entry, entries)
+    {
+        QJsonObject object = profileToJson(entry.profile, entry.pinned);
+        object.insert(QStringLiteral("key"), entry.key);
+        object.insert(QStringLiteral("pinned"), entry.pinned);
+        profiles.append(object);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), int(FormatVersion));
+    root.insert(QStringLiteral("profiles"), profiles);
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(root).toJson()) < 0
+            || !file.commit())
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: can not write profile cache" << fileName;
+    }
+}
+
+// Writes the latest entries, and again for every store() that came in meanwhile
+class SaveJob : public QRunnable
+{
+public:
+    void run();
+};
+
+void Cache::load()
+{
+    loaded = true;
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: ignoring profile cache" << fileName << error.errorString();
+        return;
+    }
+
+    const QJsonObject root = document.object();
+    const bool current = root.value(QStringLiteral("version")).toInt() == FormatVersion;
+
+    foreach (const QJsonValue &value, root.value(QStringLiteral("profiles")).toArray())
+    {
+        const QJsonObject object = value.toObject();
+
+        Entry entry;
+        entry.key = object.value(QStringLiteral("key")).toString();
+        entry.pinned = object.value(QStringLiteral("pinned")).toBool(false);
+
+        // entries of an older version are worked out again, unless pinned
+        if (entry.key.isEmpty() || (!current && !entry.pinned))
+            continue;
+
+        if (!profileFromJson(object, &entry.profile))
+        {
+            qCWarning(lcScreenExtras) << "QmlScreenExtras: skipping broken profile cache entry" << object;
+            continue;
+        }
+        entries.append(entry);
+    }
+
+    reindex();
+}
+
+// called with the mutex held, the file is written on the global thread pool
+void Cache::scheduleSave()
+{
+    savePending = true;
+    if (saving)
+        return;
+    saving = true;
+    QThreadPool::globalInstance()->start(new SaveJob);
+}
+
+void SaveJob::run()
+{
+    Cache *profiles = cache();
+    QMutexLocker locker(&profiles->mutex);
+    while (profiles->savePending)
+    {
+        profiles->savePending = false;
+        const QVector<Entry> entries = profiles->entries;
+        const QString fileName = profiles->fileName;
+
+        locker.unlock();
+        writeFile(fileName, entries);
+        locker.relock();
+    }
+    profiles->saving = false;
+}
+
+void Cache::reindex()
+{
+    byKey.clear();
+    patterns.clear();
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const Entry &entry = entries.at(i);
+        if (entry.pinned && entry.key.contains(QLatin1Char('*')))
+            patterns.append(i);
+        else
+            byKey.insert(entry.key, i);
+    }
+}
+
+const Entry *Cache::find(const QString &key) const
+{
+    const int index = byKey.value(key, -1);
+    if (index >= 0)
+        return &entries.at(index);
+
+    foreach (int pattern, patterns)
+    {
+        if (matchesPattern(entries.at(pattern).key, key))
+            return &entries.at(pattern);
+    }
+    return 0;
+}
+
+} // namespace
+
+QString key(QScreen *screen)
+{
+    QStringList parts;
+    parts << screen->name();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    parts << screen->manufacturer() << screen->model() << screen->serialNumber();
+#else
+    parts << QString() << QString() << QString();
+#endif
+
+    const QSize size = screen->size();
+    parts << QStringLiteral("%1x%2").arg(size.width()).arg(size.height())
+          << QString::number(screen->logicalDotsPerInch(), 'f', 1)
+          << QString::number(screen->physicalDotsPerInch(), 'f', 1)
+          << QString::number(screen->devicePixelRatio(), 'f', 2)
+          << FormFactorRules::systemTypeName(FormFactorRules::currentOs());
+
+    // an edited rules file has to be read again
+    const QString rules = QString::fromLocal8Bit(qgetenv("QMLSCREENEXTRAS_FORMFACTOR_RULES"));
+    if (!rules.isEmpty())
+    {
+        const QFileInfo info(rules);
+        parts << rules
+              << QString::number(info.lastModified().toMSecsSinceEpoch()) + QLatin1Char(':')
+                 + QString::number(info.size());
+    }
+
+    return parts.join(QLatin1Char('|'));
+}
+
+bool lookup(const QString &key, ScreenProfile *profile)
+{
+    Cache *profiles = cache();
+    QMutexLocker locker(&profiles->mutex);
+    if (!profiles->loaded)
+        profiles->load();
+
+    const Entry *entry = profiles->find(key);
+    if (!entry)
+        return false;
+
+    *profile = entry->profile;
+    return true;
+}
+
+void store(const QString &key, const ScreenProfile &profile)
+{
+    Cache *profiles = cache();
+    QMutexLocker locker(&profiles->mutex);
+    if (profiles->fileName.isEmpty())
+        return;
+    if (!profiles->loaded)
+        profiles->load();
+
+    const int index = profiles->byKey.value(key, -1);
+    if (index >= 0)
+    {
+        Entry &entry = profiles->entries[index];
+        if (entry.pinned)
+            return;
+        entry.profile = profile;
+    }
+    else
+    {
+        Entry entry;
+        entry.key = key;
+        entry.pinned = false;
+        entry.profile = profile;
+        profiles->entries.append(entry);
+
+        int unpinned = 0;
+        foreach (const Entry &existing, profiles->entries)
+            unpinned += existing.pinned ? 0 : 1;
+        for (int i = 0; unpinned > MaxEntries && i < profiles->entries.size(); )
+        {
+            if (profiles->entries.at(i).pinned)
+            {
+                ++i;
+                continue;
+            }
+            profiles->entries.remove(i);
+            --unpinned;
+        }
+    }
+
+    profiles->reindex();
+    profiles->scheduleSave();
+}
+
+QString fileName()
+{
+    Cache *profiles = cache();
+    QMutexLocker locker(&profiles->mutex);
+    return profiles->fileName;
+}
+
+void setEnabled(bool enabled)
+{
+    Cache *profiles = cache();
+    QMutexLocker locker(&profiles->mutex);
+    if (enabled == !profiles->fileName.isEmpty())
+        return;
+
+    profiles->fileName = enabled ? Cache::defaultFileName() : QString();
+    profiles->loaded = false;
+    profiles->entries.clear();
+    profiles->reindex();
+}
+
+} // namespace ProfileCache
@@ -0,0 +1,83 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef PROFILECACHE_H
+#define PROFILECACHE_H
+
+#include <QString>
+
+class QScreen;
+struct ScreenProfile;
+
+/*
+  Keeps what ScreenProfile::detect() worked out for every screen on disk,
+  so the next start only has to build the key of a screen and look it up.
+
+  The cache is off unless it is asked for. QMLSCREENEXTRAS_PROFILE_CACHE=1
+  or ScreenExtras::setProfileCache(true) keep qmlscreenextras-profiles.json
+  in the cache location of the application, any other value of the
+  variable is taken as the file to use.
+
+  {
+      "version": 1,
+      "profiles": [
+          {
+              "key": "HDMI-1|Dell Inc.|DELL U2415|ABC123|1920x1200|96.0|94.3|1.00|linux",
+              "pinned": false,
+              "os": "linux",
+              "formFactor": "desktop",
+              "androidDpi": "",
+              "scaleSize": 1,
+              "diagonal": 24.1
+          }
+      ]
+  }
+
+  An entry is only looked at again when the key of the screen changes. A
+  pinned entry is never replaced and any part of its key can be "*", which
+  is the way to hand a known good profile to devices that report a wrong
+  physicalSize(). Only a pinned entry can fix the font sizes with
+  "fonts": { "xxlarge": 40, "xlarge": 37.6, ... "tiny": 9.6 }, the others
+  get theirs from the font table. The file is written on the global thread
+  pool.
+*/
+namespace ProfileCache
+{
+
+// name, manufacturer, model, serial number, size, logical and physical DPI,
+// device pixel ratio and operating system of the screen, followed by the
+// form factor rules file and its time and size when QMLSCREENEXTRAS_FORMFACTOR_RULES is set
+QString key(QScreen *screen);
+
+bool lookup(const QString &key, ScreenProfile *profile);
+void store(const QString &key, const ScreenProfile &profile);
+
+// empty when the cache is turned off
+QString fileName();
+// uses the file in the cache location, or turns the cache off
+void setEnabled(bool enabled);
+
+} // namespace ProfileCache
+
+#endif // PROFILECACHE_H
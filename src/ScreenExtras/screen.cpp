@@ -22,13 +22,10 @@
  * SOFTWARE
 */
 
-
 #include "screen.h"
-#include <QCoreApplication>
-#include <qmath.h>
-#include <QScreen>
-#include <QGuiApplication>
-#include <QDebug>
+#include "profilecache.h"
+#include "screentimings.h"
+#include "unitkernels.h"
 
 
 /*!
@@ -36,6 +33,13 @@
    \inqmlmodule QmlScreenExtras
    \brief A Signleton that is used to gather information about screens and set up things like Font sizes and scale sizes
 
+   All of the values follow the primary screen. When screens are plugged in, removed or
+   reconfigured the affected values are worked out again once the event loop comes back
+   around, so a burst of changes only causes a single update.
+
+   Every QML engine gets its own ScreenExtras, but they all share the values underneath,
+   so a process with many engines only looks at the screens once.
+
    Example of using the font
 
      \code
@@ -58,26 +62,59 @@
 
 ScreenExtras::ScreenExtras(QObject *parent) :
     QObject(parent),
-    m_bInitialized(false),
-    m_gridUnit(8),
-    m_designResolution(QGuiApplication::primaryScreen ()->availableGeometry ()),
-    m_scaleSize(1.0),
-    m_formFactor("desktop"),
-    m_androidDpi(),
-    m_windowsDesktopScale(1.0),
-    m_androidScale(1.0),
-    m_tempMacVersion(6.0)
+    m_core(ScreenExtrasCore::instance())
+{
+    ScreenExtrasCore *core = m_core.data();
+
+    // the core is shared, every engine only passes its signals on
+    connect(core, &ScreenExtrasCore::gridUnitChanged, this, &ScreenExtras::gridUnitChanged);
+    connect(core, &ScreenExtrasCore::scaleSizeChanged, this, &ScreenExtras::scaleSizeChanged);
+    connect(core, &ScreenExtrasCore::formFactorChanged, this, &ScreenExtras::formFactorChanged);
+    connect(core, &ScreenExtrasCore::displaySizeChanged, this, &ScreenExtras::displaySizeChanged);
+    connect(core, &ScreenExtrasCore::devicePixelRatioChanged, this, &ScreenExtras::devicePixelRatioChanged);
+    connect(core, &ScreenExtrasCore::desktopWidthChanged, this, &ScreenExtras::desktopWidthChanged);
+    connect(core, &ScreenExtrasCore::desktopHeightChanged, this, &ScreenExtras::desktopHeightChanged);
+    connect(core, &ScreenExtrasCore::virtualWidthChanged, this, &ScreenExtras::virtualWidthChanged);
+    connect(core, &ScreenExtrasCore::virtualHeightChanged, this, &ScreenExtras::virtualHeightChanged);
+    connect(core, &ScreenExtrasCore::numberOfScreensChanged, this, &ScreenExtras::numberOfScreensChanged);
+    connect(core, &ScreenExtrasCore::primaryScreenNameChanged, this, &ScreenExtras::primaryScreenNameChanged);
+    connect(core, &ScreenExtrasCore::metricsChanged, this, &ScreenExtras::metricsChanged);
+    connect(core, &ScreenExtrasCore::pixelSnappingChanged, this, &ScreenExtras::pixelSnappingChanged);
+    connect(core, &ScreenExtrasCore::performanceTierChanged, this, &ScreenExtras::performanceTierChanged);
+}
+
+/*
+  Only has an effect before the first ScreenExtras of the process is made,
+  QMLSCREENEXTRAS_LAZY=1 does the same for apps that load the plugin.
+*/
+bool ScreenExtras::lazyInitialization()
 {
-    QScreen *desktop = QGuiApplication::primaryScreen();
+    return ScreenExtrasCore::lazyInitialization();
+}
 
+void ScreenExtras::setLazyInitialization(bool lazy)
+{
+    ScreenExtrasCore::setLazyInitialization(lazy);
+}
 
-    //FIXME need to add a update handler here for
-    // QGuiApplication::::primaryScreenChanged(QScreen *screen)
-    // QGuiApplication::screenAdded(QScreen *screen)
-    // QGuiApplication::screenRemoved(QScreen *screen)
+/*
+  The profile cache is off by default, QMLSCREENEXTRAS_PROFILE_CACHE=1
+  turns it on for apps that load the plugin. Screens that were detected
+  before it was turned on are stored the next time they change.
+*/
+bool ScreenExtras::profileCache()
+{
+    return !ProfileCache::fileName().isEmpty();
+}
 
-    initialize(desktop);
+void ScreenExtras::setProfileCache(bool enabled)
+{
+    ProfileCache::setEnabled(enabled);
+}
 
+ScreenExtrasCore *ScreenExtras::core() const
+{
+    return m_core.data();
 }
 
 /*!
@@ -95,56 +132,130 @@ ScreenExtras::ScreenExtras(QObject *parent) :
   \endlist
 
  */
-
 QString ScreenExtras::formFactor() const
 {
-    return m_formFactor;
+    return m_core->formFactor();
+}
+
+/*!
+  \qmlproperty enumeration ScreenExtras::formFactorType
+  The same as formFactor but as a enum, comparing these is cheaper than comparing strings
+  in bindings that are evaluated a lot.
+
+  \list
+  \li ScreenExtras.DESKTOP
+  \li ScreenExtras.TV
+  \li ScreenExtras.PHABLET
+  \li ScreenExtras.TABLET
+  \li ScreenExtras.PHONE
+  \endlist
+
+  \code
+  Loader {
+      source: ScreenExtras.formFactorType === ScreenExtras.PHONE ? "Phone.qml" : "Desktop.qml"
+  }
+  \endcode
+
+  The diagonals that decide the form factor can be changed without a rebuild by pointing
+  the QMLSCREENEXTRAS_FORMFACTOR_RULES environment variable at a JSON file with extra rules.
+ */
+ScreenExtras::FormFactorType ScreenExtras::formFactorType() const
+{
+    return static_cast<FormFactorType>(m_core->formFactorType());
 }
 
+/*!
+  \qmlproperty string ScreenExtras::performanceTier
+  How much the device can draw, one of "low", "medium" or "high". Where formFactor is
+  about the size of the screen this is about the CPU cores and architecture, the memory,
+  the scene graph backend and the device pixels per second of the primary screen. Software
+  rendering is always "low".
+
+  \code
+  DropShadow {
+      visible: ScreenExtras.performanceTier !== "low"
+  }
+  \endcode
+
+  It is worked out once and again only when the primary screen changes. Set
+  QMLSCREENEXTRAS_PERFORMANCE_TIER to a tier to force it, or to a JSON file that sets "tier"
+  or replaces any of the values in deviceCapabilities.
+
+  \sa deviceCapabilities
+ */
+QString ScreenExtras::performanceTier() const
+{
+    return m_core->performanceTier();
+}
 
-bool ScreenExtras::isInitialized()
+/*!
+  \qmlproperty object ScreenExtras::deviceCapabilities
+  The values performanceTier was worked out from: cpuCores, cpuArchitecture, totalMemoryMB,
+  graphicsBackend, pixelWidth, pixelHeight, refreshRate and megapixelsPerSecond.
+ */
+QVariantMap ScreenExtras::deviceCapabilities() const
 {
-    return m_bInitialized;
+    return m_core->deviceCapabilities();
 }
 
-void ScreenExtras::initialize(QScreen *screen)
+double ScreenExtras::gridUnit() const
 {
+    return m_core->gridUnit();
+}
 
-    m_devicePixelRatio = screen->devicePixelRatio();
-    m_desktopGeometry = screen->geometry();
+/*!
+ \qmlproperty double ScreenExtras::exactGridUnit
+    The grid unit as it was worked out for the screen, whether pixelSnapping is on or not.
+ */
+double ScreenExtras::exactGridUnit() const
+{
+    return m_core->exactGridUnit();
+}
 
-    setDesktopHeight(screen->availableGeometry().height() );
-    setDesktopWidth(screen->availableGeometry().width() );
+/*!
+ \qmlproperty double ScreenExtras::snappedGridUnit
+    The grid unit rounded to whole device pixels, whether pixelSnapping is on or not.
+    With a devicePixelRatio of 1.5 and a grid unit of 9 px this is 9.33 px, 14 device pixels.
+ */
+double ScreenExtras::snappedGridUnit() const
+{
+    return m_core->snappedGridUnit();
+}
 
-    setVirtualHeight( screen->availableVirtualGeometry().height() );
-    setVirtualWidth(screen->availableVirtualGeometry().width());
+/*!
+ \qmlproperty bool ScreenExtras::pixelSnapping
+    With a fractional devicePixelRatio such as 1.25 or 1.5 a grid unit usually does not
+    cover a whole number of device pixels, so borders end up between pixels and look blurry.
+    While this is on gridUnit, gu(), units and the fonts are rounded to whole device pixels,
+    and so are the values of WindowScreen for the screen of each window.
+    Bindings that need the exact values can still use exactGridUnit and guExact().
 
-    setNumberOfScreens(QGuiApplication::screens().length());
-    setDevicePixelRatio(screen->devicePixelRatio());
+    It is off unless QMLSCREENEXTRAS_PIXEL_SNAPPING=1 is set, and it is the same for every
+    QML engine of the process.
 
-    setPrimaryScreenName(screen->name());
+\code
+    Component.onCompleted: ScreenExtras.pixelSnapping = true
+\endcode
 
-    updateFormFactor();
-    m_bInitialized = true;
+\sa snappedGridUnit, guSnapped()
+ */
+bool ScreenExtras::pixelSnapping() const
+{
+    return m_core->pixelSnapping();
 }
 
-void ScreenExtras::setGridUnit(const double &unit)
+void ScreenExtras::setPixelSnapping(bool snapping)
 {
-    if( m_gridUnit == unit )
-    {
-        return;
-    }
-    else
-    {
-        m_gridUnit = (unit * m_gridUnit) ;
-        emit gridUnitChanged();
-    }
-    updateFonts();
+    m_core->setPixelSnapping(snapping);
 }
 
-double ScreenExtras::gridUnit() const
+/*!
+ \qmlproperty double ScreenExtras::scaleSize
+  returns what QScreen thinks the scaleSize should be set to.  I would not use this.
+ */
+double ScreenExtras::scaleSize() const
 {
-    return m_gridUnit;
+    return m_core->scaleSize();
 }
 
 /*!
@@ -157,15 +268,7 @@ double ScreenExtras::gridUnit() const
 */
 int ScreenExtras::desktopWidth() const
 {
-    return m_desktopWidth;
-}
-
-void ScreenExtras::setDesktopWidth(const int &desktopWidth)
-{
-    if(m_desktopWidth == desktopWidth)
-        return;
-    m_desktopWidth = desktopWidth;
-    emit desktopWidthChanged();
+    return m_core->desktopWidth();
 }
 
 /*!
@@ -177,19 +280,9 @@ void ScreenExtras::setDesktopWidth(const int &desktopWidth)
 */
 int ScreenExtras::desktopHeight() const
 {
-    return m_desktopHeight;
-}
-
-
-void ScreenExtras::setDesktopHeight(const int &desktopHeight)
-{
-    if(m_desktopHeight == desktopHeight)
-        return;
-    m_desktopHeight = desktopHeight;
-    emit desktopHeightChanged();
+    return m_core->desktopHeight();
 }
 
-
 /*!
  \qmlproperty int ScreenExtras::virtualWidth
     This property holds the available width of the Screen minus what the
@@ -197,15 +290,7 @@ void ScreenExtras::setDesktopHeight(const int &desktopHeight)
  */
 int ScreenExtras::virtualWidth() const
 {
-    return m_virtualWidth;
-}
-
-void ScreenExtras::setVirtualWidth(const int &virtualWidth)
-{
-    if ( m_virtualWidth == virtualWidth )
-        return;
-    m_virtualWidth = virtualWidth ;
-    emit virtualWidthChanged();
+    return m_core->virtualWidth();
 }
 
 /*!
@@ -215,15 +300,7 @@ void ScreenExtras::setVirtualWidth(const int &virtualWidth)
  */
 int ScreenExtras::virtualHeight() const
 {
-    return m_virtualHeight;
-}
-
-void ScreenExtras::setVirtualHeight(const int &virtualHeight)
-{
-    if ( m_virtualHeight == virtualHeight )
-        return;
-    m_virtualHeight = virtualHeight ;
-    emit virtualHeightChanged();
+    return m_core->virtualHeight();
 }
 
 /*!
@@ -233,22 +310,12 @@ system the application is connected to.
 */
 int ScreenExtras::numberOfScreens() const
 {
-    return m_numberOfScreens;
-}
-
-void ScreenExtras::setNumberOfScreens(const int &numberOfScreens)
-{
-    if(m_numberOfScreens == numberOfScreens)
-        return;
-    m_numberOfScreens = numberOfScreens;
-    emit numberOfScreensChanged();
+    return m_core->numberOfScreens();
 }
 
-
-
 double ScreenExtras::displaySize() const
 {
-    return m_displayDiagonalSize;
+    return m_core->displaySize();
 }
 
 /*!
@@ -257,28 +324,70 @@ double ScreenExtras::displaySize() const
 */
 QString ScreenExtras::primaryScreenName() const
 {
-    return  m_primaryScreenName;
+    return m_core->primaryScreenName();
 }
 
-void ScreenExtras::setPrimaryScreenName(const QString &primaryScreenName)
+double ScreenExtras::devicePixelRatio() const
 {
-    if(m_primaryScreenName == primaryScreenName)
-        return;
-    m_primaryScreenName = primaryScreenName;
-    emit primaryScreenNameChanged();
+    return m_core->devicePixelRatio();
 }
 
-double ScreenExtras::devicePixelRatio() const
+/*!
+ \qmlproperty ScreenMetrics ScreenExtras::metrics
+    A copy of all the values above that is replaced in one go after every update.
+
+    Each property of ScreenExtras has its own changed signal, so a binding that reads
+    several of them is evaluated once for every one that changed. Reading the same
+    values through metrics makes the binding depend on metricsChanged only, so it is
+    evaluated once per update.
+
+\code
+    Rectangle {
+        width: ScreenExtras.metrics.desktopWidth - ScreenExtras.metrics.gridUnit * 4
+    }
+\endcode
+
+C++ code on the render thread or a worker thread can not touch ScreenExtras, it gets the
+same copy, font sizes included, from ScreenMetrics::current() without taking a lock.
+
+\code
+    std::shared_ptr<const ScreenMetrics> metrics = ScreenMetrics::current();
+    const double margin = metrics->gridUnit * 2;
+    font.setPixelSize(metrics->font(ScreenExtras::NORMAL));
+\endcode
+
+\sa generation
+ */
+ScreenMetrics ScreenExtras::metrics() const
 {
-    return m_devicePixelRatio;
+    return m_core->metrics();
 }
 
-void ScreenExtras::setDevicePixelRatio(const double &devicePixelRatio)
+/*!
+ \qmlproperty int ScreenExtras::generation
+    Counts the updates. It goes up by one each time metricsChanged is emitted.
+ */
+int ScreenExtras::generation() const
+{
+    return m_core->generation();
+}
+
+/*!
+ \qmlproperty object ScreenExtras::initTimings
+    How long the parts of getting ScreenExtras ready took, in milliseconds.
+
+    This is empty unless timing was turned on before the plugin was loaded, either with
+    QMLSCREENEXTRAS_TIMINGS=1 or with QT_LOGGING_RULES="qmlscreenextras.timing.debug=true"
+    which also prints every phase. The keys are pluginLoad, construction, screens,
+    systemInfo, formFactor, fonts, screenModel and deviceProbe, each holding its last run.
+
+\code
+    Component.onCompleted: console.log(JSON.stringify(ScreenExtras.initTimings))
+\endcode
+ */
+QVariantMap ScreenExtras::initTimings() const
 {
-    if (m_devicePixelRatio == devicePixelRatio)
-        return;
-    m_devicePixelRatio = devicePixelRatio;
-    emit devicePixelRatioChanged();
+    return ScreenTimings::toVariantMap();
 }
 
 /*!
@@ -289,6 +398,9 @@ This helper class.
 Each grid unit by default it 8px the example below show what a rectangles height
 should be at 80px. So in other words it multiplys the passed in int by 8 if there is no scale size.
 
+\note A binding that calls gu() is not updated when the grid unit changes. Use
+units or gridUnit in bindings that have to follow the screen.
+
 Example:
 
 \code
@@ -304,22 +416,165 @@ Example:
  */
 double ScreenExtras::gu(double units)
 {
-    return units * m_gridUnit;
+    return m_core->gu(units);
+}
+
+/*!
+ \qmlmethod ScreenExtras::guExact(double units)
+    gu() without pixel snapping.
+ */
+double ScreenExtras::guExact(double units)
+{
+    return m_core->guExact(units);
+}
+
+/*!
+ \qmlmethod ScreenExtras::guSnapped(double units)
+    gu() rounded to whole device pixels, whether pixelSnapping is on or not.
+ */
+double ScreenExtras::guSnapped(double units)
+{
+    return m_core->guSnapped(units);
 }
 
 double ScreenExtras::pxToGu(double px)
 {
-    return px / m_gridUnit;
+    return m_core->pxToGu(px);
+}
+
+/*!
+ \qmlmethod ScreenExtras::guArray(list<real> units)
+    gu() for a whole array at once, the returned array holds the pixels. For large
+    arrays this is a lot cheaper than calling gu() for every element.
+
+\code
+    var px = ScreenExtras.guArray(points)
+\endcode
+
+\sa pxToGuArray(), snapArray(), guBuffer()
+ */
+QVector<qreal> ScreenExtras::guArray(QVector<qreal> units)
+{
+    UnitKernels::scale(units.data(), units.size(), qreal(m_core->gridUnit()));
+    if (m_core->pixelSnapping())
+        UnitKernels::snap(units.data(), units.size(), qreal(m_core->devicePixelRatio()));
+    return units;
+}
+
+/*!
+ \qmlmethod ScreenExtras::pxToGuArray(list<real> px)
+    pxToGu() for a whole array at once.
+ */
+QVector<qreal> ScreenExtras::pxToGuArray(QVector<qreal> px)
+{
+    UnitKernels::scale(px.data(), px.size(), qreal(1.0 / m_core->gridUnit()));
+    return px;
+}
+
+/*!
+ \qmlmethod ScreenExtras::snapArray(list<real> px)
+    Rounds every value to the nearest whole pixel of the primary screen, which for a
+    devicePixelRatio of 1.5 are steps of 2/3 px.
+ */
+QVector<qreal> ScreenExtras::snapArray(QVector<qreal> px)
+{
+    UnitKernels::snap(px.data(), px.size(), qreal(m_core->devicePixelRatio()));
+    return px;
+}
+
+/*!
+ \qmlmethod ScreenExtras::guBuffer(ArrayBuffer buffer)
+    The same as guArray() for the buffer of a Float32Array. The floats are converted
+    where they are without going through JavaScript numbers, which makes this the
+    fastest way to convert large point sets.
+
+\code
+    var points = new Float32Array(count * 2)
+    ...
+    var px = new Float32Array(ScreenExtras.guBuffer(points.buffer))
+\endcode
+
+\sa pxToGuBuffer(), snapBuffer()
+ */
+QByteArray ScreenExtras::guBuffer(QByteArray buffer)
+{
+    float *values = reinterpret_cast<float *>(buffer.data());
+    const int count = buffer.size() / int(sizeof(float));
+    UnitKernels::scale(values, count, float(m_core->gridUnit()));
+    if (m_core->pixelSnapping())
+        UnitKernels::snap(values, count, float(m_core->devicePixelRatio()));
+    return buffer;
+}
+
+/*!
+ \qmlmethod ScreenExtras::pxToGuBuffer(ArrayBuffer buffer)
+    pxToGuArray() for the buffer of a Float32Array.
+ */
+QByteArray ScreenExtras::pxToGuBuffer(QByteArray buffer)
+{
+    UnitKernels::scale(reinterpret_cast<float *>(buffer.data()), buffer.size() / int(sizeof(float)),
+                       float(1.0 / m_core->gridUnit()));
+    return buffer;
+}
+
+/*!
+ \qmlmethod ScreenExtras::snapBuffer(ArrayBuffer buffer)
+    snapArray() for the buffer of a Float32Array.
+ */
+QByteArray ScreenExtras::snapBuffer(QByteArray buffer)
+{
+    UnitKernels::snap(reinterpret_cast<float *>(buffer.data()), buffer.size() / int(sizeof(float)),
+                      float(m_core->devicePixelRatio()));
+    return buffer;
+}
+
+/*!
+ \qmlproperty ScreenModel ScreenExtras::screens
+    A model with a row for every screen that keeps its values up to date.
+    Prefer this over screenNameAt() and screenRefreshRateAt() in delegates.
+
+\code
+    Repeater {
+        model: ScreenExtras.screens
+        Text { text: model.name + " " + model.gridUnit }
+    }
+\endcode
+
+\sa ScreenModel
+ */
+ScreenModel *ScreenExtras::screens() const
+{
+    return m_core->screens();
+}
+
+/*!
+ \qmlproperty GridUnits ScreenExtras::units
+    Common grid unit sizes as properties. Unlike gu() bindings on these are updated
+    when the grid unit changes and they do not call into C++ each time.
+
+\code
+    Rectangle {
+        height: ScreenExtras.units.gu10
+        width: ScreenExtras.units.gridUnit * 25
+    }
+\endcode
+
+\sa GridUnits, gu()
+ */
+GridUnits *ScreenExtras::units() const
+{
+    return m_core->units();
 }
 
 /*!
  \qmlmethod  ScreenExtras::screenNameAt(int screenNumber)
  returns the name of a a screen at a given int
- */
 
+ \sa screens
+ */
 QString ScreenExtras::screenNameAt(const int &screenNumber)
 {
-    return QGuiApplication::screens().at(screenNumber)->name();
+    return m_core->screenNameAt(screenNumber);
 }
 
 /*!
@@ -333,11 +588,11 @@ QString ScreenExtras::screenNameAt(const int &screenNumber)
     ScreenExtras.screenRefreshRateAt(2)
 \endcode
 
-\sa numberOfScreens
+\sa numberOfScreens, screens
  */
 qreal ScreenExtras::screenRefreshRateAt(const int &screenNumber)
 {
-    return QGuiApplication::screens().at(screenNumber)->refreshRate();
+    return m_core->screenRefreshRateAt(screenNumber);
 }
 
 /*!
@@ -354,436 +609,25 @@ qreal ScreenExtras::screenRefreshRateAt(const int &screenNumber)
 
      see also the types of font sizes
  */
-
 double ScreenExtras::font(ScreenExtras::Font fontSize)
 {
-    return m_fonts[fontSize];
-}
-
-void ScreenExtras::finalFormFactor(
-        const QString &systemType,
-        const double &versionORscaleSize,
-        const double diagonal )
-{
-    //FIXME SHould be getters and setters
-
-    m_systemType = systemType;
-    m_displayDiagonalSize = diagonal;
-
-    // IOS
-
-    if ( systemType == "ios"){
-        if (diagonal >= 3.5 && diagonal < 5) {
-            m_formFactor = "phone";
-        }
-        //iPhone 1st generation to phablet
-        else if (diagonal >= 5 && diagonal < 6.5) {
-            m_formFactor = "phablet";
-        }
-        else if (diagonal >= 6.5 && diagonal < 10.1) {
-            m_formFactor = "tablet";
-        }
-        // apple TV
-        else if (diagonal > 10.1 ){
-            m_formFactor  = "tv";
-        }
-        setGridUnit(versionORscaleSize);
-        setScaleSize(versionORscaleSize);
-    }
-
-    // ANDROID
-    else if (systemType == "android" ){
-        if (diagonal >= 3.5 && diagonal < 5) {
-            m_formFactor = "phone";
-        }
-        //iPhone 1st generation to phablet
-        else if (diagonal >= 5 && diagonal < 6.5) {
-            m_formFactor = "phablet";
-        }
-        else if (diagonal >= 6.5 && diagonal < 10.1) {
-            m_formFactor = "tablet";
-        }
-        // android TV
-        else if (diagonal > 10.1 ){
-            m_formFactor  = "tv";
-        }
-        setGridUnit(versionORscaleSize);
-        setScaleSize(versionORscaleSize);
-    }
-
-    // WINDOWS
-    else if ( systemType == "winrt"
-              || systemType == "wince"
-              || systemType == "windows"
-              ){
-        if (diagonal >= 3.5 && diagonal < 5) {
-            m_formFactor = "phone";
-        }
-        //iPhone 1st generation to phablet
-        else if (diagonal >= 5 && diagonal < 6.5) {
-            m_formFactor = "phablet";
-        }
-        else if (diagonal >= 6.5 && diagonal < 10.1) {
-            m_formFactor = "tablet";
-        }
-        // FIXME TV
-        else if (diagonal > 10.1  ){
-            m_formFactor  = "desktop";
-        }
-        setGridUnit(versionORscaleSize);
-        setScaleSize(versionORscaleSize);
-    }
-
-    //OSX
-    if ( systemType == "osx"){
-        if (diagonal >= 3.5 && diagonal < 5) {
-            m_formFactor = "phone";
-        }
-        //iPhone 1st generation to phablet
-        else if (diagonal >= 5 && diagonal < 6.5) {
-            m_formFactor = "phablet";
-        }
-        else if (diagonal >= 6.5 && diagonal < 10.1) {
-            m_formFactor = "tablet";
-        }
-        // apple TV
-        else if (diagonal > 10.1 ){
-            m_formFactor  = "desktop";
-        }
-        setGridUnit(versionORscaleSize);
-        setScaleSize(versionORscaleSize);
-    }
-
-
-    if ( systemType == "linux"){
-        if (diagonal >= 3.5 && diagonal < 5) {
-            m_formFactor = "phone";
-        }
-        //iPhone 1st generation to phablet
-        else if (diagonal >= 5 && diagonal < 6.5) {
-            m_formFactor = "phablet";
-        }
-        else if (diagonal >= 6.5 && diagonal < 10.1) {
-            m_formFactor = "tablet";
-        }
-        // apple TV
-        else if (diagonal > 10.1 ){
-            m_formFactor  = "desktop";
-        }
-        setGridUnit(versionORscaleSize);
-        setScaleSize(versionORscaleSize);
-    }
-
-
-
-}
-
-double ScreenExtras::checkIphoneScaleSize(
-        const int &width,
-        const int &height,
-        const double &iPhoneVersion )
-{
-    if( iPhoneVersion >= 4 )
-    {
-        if (width >= 320 && width < 321&& height < 567 ){
-            return 1.0;
-        }
-        else if (height >  567 && height < 569 && width  == 320){
-            return 1.0;
-        }
-        else if (height >  665  && height < 668 && width  == 375)
-        {
-            return 1.0;
-        }
-        else if (width >= 374  && height  >= 665 )
-        {
-            return 1.0;
-        }
-    }
-    else
-    {
-        return 1.0;
-    }
-    return 1.0;
-}
-
-void ScreenExtras::updateFormFactor()
-{
-    QScreen* m_screen = QGuiApplication::primaryScreen();
-    QSysInfo sysInfo;
-
-    double m_169 = qSqrt(
-                pow((m_screen->physicalSize().width()), 2) +
-                qPow((m_screen->physicalSize().height()), 2)) * 0.039370;
-
-    // Check to see if this is a ios
-
-    if ( sysInfo.productType () == "ios")
-    {
-        // IOS - now what version?
-
-        if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_4_3){
-            m_tempMacVersion = 4.3;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_5_0){
-            m_tempMacVersion =  5.0;
-        }
-        else if (sysInfo.MacintoshVersion ==  QSysInfo::MV_IOS_5_1){
-            m_tempMacVersion =  5.1;
-        }
-        else if (sysInfo.MacintoshVersion ==   QSysInfo::MV_IOS_6_0){
-            m_tempMacVersion =  6.0;
-        }
-        else if (sysInfo.MacintoshVersion ==  QSysInfo::MV_IOS_6_1){
-            m_tempMacVersion =  6.1;
-        }
-        else if (sysInfo.MacintoshVersion ==  QSysInfo::MV_IOS_7_0){
-            m_tempMacVersion =  7.0;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_7_1){
-            m_tempMacVersion =   7.1;
-        }
-        else if (sysInfo.MacintoshVersion ==  QSysInfo::MV_IOS_8_0){
-            m_tempMacVersion =  8.0;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_8_1){
-            m_tempMacVersion =   8.1;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_8_2){
-            m_tempMacVersion = 8.2;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_8_3){
-            m_tempMacVersion =  8.3;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_8_4){
-            m_tempMacVersion =  8.4;
-        }
-        else if (sysInfo.MacintoshVersion == QSysInfo::MV_IOS_9_0){
-            m_tempMacVersion =  9.0;
-        }
-
-        finalFormFactor( "ios",
-                         checkIphoneScaleSize(
-                             m_screen->size().width(),
-                             m_screen->size().height(),
-                             m_tempMacVersion),
-                         m_169 );
-        return;
-    }
-    // ANDROID / LINUX
-    else  if( sysInfo.productType () == "android")
-    {
-        // Check the BuildArch to see if arm or arm 64.
-        // Also look at x86_64 android
-        if( sysInfo.buildCpuArchitecture() == "arm"
-                ||  sysInfo.buildCpuArchitecture() == "arm64")
-        {
-            // SOURCE:
-            // https://developer.android.com/guide/practices/screens_support.html
-            //(low) 120dpi
-
-            if(m_screen->logicalDotsPerInch () <= 120)
-            {
-                m_androidDpi = "ldpi";
-                m_androidScale = 1.0;
-            }
-
-            else if (m_screen->logicalDotsPerInch() <= 160)
-            {
-                m_androidDpi = "mdpi";
-                m_androidScale = 1.5;
-            }
-            //(high) ~240dpi
-            else if (m_screen->logicalDotsPerInch() <= 240)
-            {
-                m_androidDpi = "hdpi";
-                m_androidScale = 2.0;
-            }
-            //(high) ~240dpi
-            else if (m_screen->logicalDotsPerInch()  <= 320)
-            {
-                m_androidDpi = "xhdpi" ;
-                m_androidScale = 3.0;
-            }
-            // (extra-high) ~320dpi
-            else if (m_screen->logicalDotsPerInch() <= 480)
-            {
-                m_androidDpi = "xxhdpi" ;
-                m_androidScale  = 4.0;
-            }
-
-            // (extra-extra-high) ~480dpi
-            else if (m_screen->logicalDotsPerInch() <= 640 )
-            {
-                m_androidDpi = "xxxhdpi";
-                m_androidScale = 5.0;
-            }
-
-            //(extra-extra-extra-high) ~640dpi
-            else //if (m_screen->logicalDotsPerInch() >= 640)
-            {
-                m_androidDpi = "xxxhdpi";
-                m_androidScale = 5.0;
-            }
-        }
-        else
-        {
-            qDebug() << "we know that it is android but we do not know the DPI so we have to make another work around";
-            return;
-        }
-        finalFormFactor( "android" , m_androidScale, m_169 );
-
-        return;
-    }
-
-    // WINDOWS PHONE
-
-    else if ( sysInfo.productType() == "winphone"){
-        // FIXME
-    }
-    // WINDOWS LOOK FOR DPI
-    else if( sysInfo.productType () == "winrt"
-             || sysInfo.productType () == "wince"
-             || sysInfo.productType () == "windows" )
-    {
-        m_windowsDesktopScale = 1.0;
-        // SOURCE
-        // https://msdn.microsoft.com/en-us/library/windows/desktop/dn469266(v=vs.85).aspx
-        if (m_169 <= 10.5){
-            qDebug() << "This is small to small !";
-        }
-        else if (m_169 >=  10.6 && m_169 <=  11.5){
-            if (m_screen->size().width() >= 1920 && m_screen->size().height() >= 1080){
-                m_windowsDesktopScale = 1.5;
-            }
-        }
-        else if (m_169 >=  11.6 && m_169 <= 13.2){
-            if (m_screen->size().width() >= 1920 && m_screen->size().height() >= 1200){
-                m_windowsDesktopScale = 1.5;
-            }
-        }
-        else if (m_169 >=  13.3 && m_169 <= 15.3){
-            if(m_screen->logicalDotsPerInch() >= 192 && m_screen->logicalDotsPerInch() >145) {
-                m_windowsDesktopScale = 2.0;
-            }
-        }
-        else if (m_169 >=  15.4 && m_169 <= 16.9){
-            if ( m_screen->logicalDotsPerInch() >= 120 && m_screen->logicalDotsPerInch()  < 192){
-                m_windowsDesktopScale = 1.25;
-            }
-            else if (m_screen->logicalDotsPerInch() >= 192  )
-            {
-                m_windowsDesktopScale = 2.0;
-            }
-        }
-        else if (m_169 >=  23 && m_169 < 24){
-            if (m_screen->logicalDotsPerInch() >= 192){
-                m_windowsDesktopScale = 2.0;
-            }
-        }
-        else if (m_169 >=  23 && m_169 < 24){
-            if (m_screen->logicalDotsPerInch() == 120 ){
-                m_windowsDesktopScale = 1.25;
-            }
-        }
-        else {
-            finalFormFactor ("windows" , 1.0,m_169);
-            return;
-        }
-        finalFormFactor ("windows", m_windowsDesktopScale,m_169);
-        return;
-    }
-    // END WINDOWS
-
-    // MACOSX
-
-    if(sysInfo.productType() == "osx"){
-        finalFormFactor ("osx", 1 , m_169);
-        return;
-    }
-    // START LINUX (SOMETIMES ANDROID COes back as Linux)
-    // if ( sysInfo.buildCpuArchitecture() === "arm" || systemInfo.buildCpuArchitecture == "arm64" && systemInfo.productType() == "android" || sysInfo.productType () == "linux")
-    //{
-    //  // Ok know that we know that we are on a armv7 lets look deeper
-    //}
-
-    if( sysInfo.kernelType() == "linux" && sysInfo.productType() != "android")
-    {
-        finalFormFactor ("linux", 1 , m_169);
-        return;
-    }
-
+    return m_core->font(fontSize);
 }
 
 /*!
- \qmlproperty double ScreenExtras::scaleSize
-  returns what QScreen thinks the scaleSize should be set to.  I would not use this.
- */
-
-double ScreenExtras::scaleSize() const
-{
-    return m_scaleSize;
-}
+    \qmlproperty ScreenFonts ScreenExtras::fonts
+     The same sizes as font() but as properties. A binding on one of these is only
+     evaluated again when the sizes change and it skips the call into font().
 
-void ScreenExtras::setScaleSize(const double &size)
-{
-    if( m_scaleSize == size) return;
-    m_scaleSize = size;
-    emit scaleSizeChanged();
-}
+     \code
+     Text{
+        font.pixelSize: ScreenExtras.fonts.normal
+     }
+     \endcode
 
-void ScreenExtras::updateFonts()
+     \sa ScreenFonts
+ */
+ScreenFonts *ScreenExtras::fonts() const
 {
-    if (m_formFactor == "desktop")
-    {
-        m_fonts[XXLARGE] = gu(5);
-        m_fonts[XLARGE] = gu(4.7);
-        m_fonts[LARGE] = gu(4);
-        m_fonts[MEDIUM] = gu(3.5);
-        m_fonts[NORMAL] = gu(2.5);
-        m_fonts[SMALL] = gu(2);
-        m_fonts[TINY] = gu(1.2);
-    }
-    else if (m_formFactor == "tv")
-    {
-        m_fonts[XXLARGE] = gu(10);
-        m_fonts[XLARGE] = gu(8);
-        m_fonts[LARGE] = gu(6);
-        m_fonts[MEDIUM] = gu(4.5);
-        m_fonts[NORMAL] = gu(3.5);
-        m_fonts[SMALL] = gu(3);
-        m_fonts[TINY] = gu(2);
-    }
-    // FIXME make this with android and iphone options
-    else if (m_formFactor == "tablet")
-    {
-        m_fonts[XXLARGE] = gu(5);
-        m_fonts[XLARGE] = gu(4.7);
-        m_fonts[LARGE] = gu(4);
-        m_fonts[MEDIUM] = gu(3.5);
-        m_fonts[NORMAL] = gu(2.5);
-        m_fonts[SMALL] = gu(2);
-        m_fonts[TINY] = gu(1.2);
-    }
-    else if (m_formFactor == "phone" && m_systemType == "ios")
-    {
-        m_fonts[XXLARGE] = gu(5);
-        m_fonts[XLARGE] = gu(4.6);
-        m_fonts[LARGE] = gu(3.0);
-        m_fonts[MEDIUM] = gu(2.8);
-        m_fonts[NORMAL] = gu(2.0);
-        m_fonts[SMALL] = gu(1.5);
-        m_fonts[TINY] = gu(.5);
-    }
-    else if (m_formFactor == "phone" && m_systemType == "android")
-    {
-        m_fonts[XXLARGE] = gu(6);
-        m_fonts[XLARGE] = gu(5.6);
-        m_fonts[LARGE] = gu(4.3);
-        m_fonts[MEDIUM] = gu(3.8);
-        m_fonts[NORMAL] = gu(3.0);
-        m_fonts[SMALL] = gu(2.5);
-        m_fonts[TINY] = gu(1.2);
-    }
+    return m_core->fonts();
 }
-
@@ -27,11 +27,10 @@
 
 #include <QObject>
 #include <QtQml>
-#include <QObject>
-#include <QtQml>
-#include <QScreen>
-#include <QSysInfo>
 #include <QString>
+#include <QSharedPointer>
+
+#include "screenextrascore.h"
 
 class ScreenExtras : public QObject
 {
@@ -45,10 +44,23 @@ class ScreenExtras : public QObject
     Q_PROPERTY( double displaySize READ displaySize NOTIFY displaySizeChanged )
     Q_PROPERTY( double devicePixelRatio READ devicePixelRatio NOTIFY devicePixelRatioChanged )
     Q_PROPERTY( double gridUnit READ gridUnit NOTIFY gridUnitChanged )
+    Q_PROPERTY( double exactGridUnit READ exactGridUnit NOTIFY gridUnitChanged )
+    Q_PROPERTY( double snappedGridUnit READ snappedGridUnit NOTIFY gridUnitChanged )
+    Q_PROPERTY( bool pixelSnapping READ pixelSnapping WRITE setPixelSnapping NOTIFY pixelSnappingChanged )
     Q_PROPERTY( double scaleSize READ scaleSize NOTIFY scaleSizeChanged )
     Q_PROPERTY( QString primaryScreenName READ primaryScreenName NOTIFY primaryScreenNameChanged )
     Q_PROPERTY( QString formFactor READ formFactor NOTIFY formFactorChanged )
+    Q_PROPERTY( FormFactorType formFactorType READ formFactorType NOTIFY formFactorChanged )
+    Q_PROPERTY( QString performanceTier READ performanceTier NOTIFY performanceTierChanged )
+    Q_PROPERTY( QVariantMap deviceCapabilities READ deviceCapabilities NOTIFY performanceTierChanged )
+    Q_PROPERTY( ScreenMetrics metrics READ metrics NOTIFY metricsChanged )
+    Q_PROPERTY( int generation READ generation NOTIFY metricsChanged )
+    Q_PROPERTY( QVariantMap initTimings READ initTimings NOTIFY metricsChanged )
+    Q_PROPERTY( ScreenModel *screens READ screens CONSTANT )
+    Q_PROPERTY( ScreenFonts *fonts READ fonts CONSTANT )
+    Q_PROPERTY( GridUnits *units READ units CONSTANT )
     Q_ENUMS( Font )
+    Q_ENUMS( FormFactorType )
 
 
 
@@ -69,60 +81,73 @@ public:
         TINY
     };
 
+    // same order as FormFactorRules::Type
+    enum FormFactorType
+    {
+        DESKTOP,
+        TV,
+        PHABLET,
+        TABLET,
+        PHONE
+    };
+
+    FormFactorType formFactorType() const;
+
+    QString performanceTier() const;
+    QVariantMap deviceCapabilities() const;
+
+    // has to be set before the first ScreenExtras is created
+    static bool lazyInitialization();
+    static void setLazyInitialization(bool lazy);
+    // best set before the first ScreenExtras is created as well
+    static bool profileCache();
+    static void setProfileCache(bool enabled);
 
     double gridUnit()const;
-    void setGridUnit(const double &unit);
+    double exactGridUnit() const;
+    double snappedGridUnit() const;
 
-    double scaleSize()const;
-    void setScaleSize(const double &size);
+    bool pixelSnapping() const;
+    void setPixelSnapping(bool snapping);
 
+    double scaleSize()const;
     int desktopWidth() const;
-    void setDesktopWidth(const int &desktopWidth);
-
     int desktopHeight() const;
-    void setDesktopHeight(const int &desktopHeight);
-
     int virtualWidth() const;
-    void setVirtualWidth(const int &designWidth);
-
     int virtualHeight() const;
-    void setVirtualHeight(const int &designHeight);
-
     int numberOfScreens()const;
-    void setNumberOfScreens(const int &numberOfScreens);
-
     double displaySize()const;
-    void setDisplaySize(const double &displaySize);
-
     QString primaryScreenName()const;
-    void setPrimaryScreenName(const QString &primaryScreenName);
-
     double devicePixelRatio()const;
-    void setDevicePixelRatio(const double &devicePixelRatio);
+
+    ScreenMetrics metrics() const;
+    int generation() const;
+    QVariantMap initTimings() const;
+
+    ScreenModel *screens() const;
 
     Q_INVOKABLE double gu(double units);
+    Q_INVOKABLE double guExact(double units);
+    Q_INVOKABLE double guSnapped(double units);
     Q_INVOKABLE double pxToGu(double px);
+
+    // whole arrays at once, the buffers are the ones of a Float32Array
+    Q_INVOKABLE QVector<qreal> guArray(QVector<qreal> units);
+    Q_INVOKABLE QVector<qreal> pxToGuArray(QVector<qreal> px);
+    Q_INVOKABLE QVector<qreal> snapArray(QVector<qreal> px);
+    Q_INVOKABLE QByteArray guBuffer(QByteArray buffer);
+    Q_INVOKABLE QByteArray pxToGuBuffer(QByteArray buffer);
+    Q_INVOKABLE QByteArray snapBuffer(QByteArray buffer);
+
     Q_INVOKABLE QString screenNameAt(const int &screenNumber);
     Q_INVOKABLE qreal screenRefreshRateAt(const int &screenNumber);
     Q_INVOKABLE double font(Font fontSize);
 
+    ScreenFonts *fonts() const;
+    GridUnits *units() const;
 
-protected:
-    // internal
-
-
-    void finalFormFactor( const QString &systemType, const double &versionORscaleSize ,
-                          const double diagonal);
-
-    double checkIphoneScaleSize( const int &width, const int &height,
-                                 const double &iPhoneVersion);
-
-    void updateFormFactor();
-    void updateFonts();
-    bool isInitialized();
-
-protected slots:
-     void initialize(QScreen *screen);
+    // the state shared with the ScreenExtras of every other engine
+    ScreenExtrasCore *core() const;
 
 signals:
     void gridUnitChanged();
@@ -139,39 +164,12 @@ signals:
     void numberOfScreensChanged();
     void primaryScreenNameChanged();
 
-private:
-    bool m_bInitialized;
-
-    double m_gridUnit;
-    double m_defaultGrid;
-    double m_devicePixelRatio;
-    double m_displayDiagonalSize;
-
-
-    int m_desktopWidth;
-    int m_desktopHeight;
-    int m_virtualWidth;
-    int m_virtualHeight;
-
-    int m_numberOfScreens;
-
-    QRect m_desktopGeometry;
-    QRect m_designResolution;
-
-    QMap<Font,double> m_fonts;
-
-    double m_scaleSize;
-
-    QString m_formFactor;
-    QString m_androidDpi;
-
-    double m_windowsDesktopScale;
-    double m_androidScale;
-    double m_tempMacVersion;
-
-    QString m_systemType;
-    QString m_primaryScreenName;
+    void metricsChanged(int generation);
+    void pixelSnappingChanged();
+    void performanceTierChanged();
 
+private:
+    QSharedPointer<ScreenExtrasCore> m_core;
 };
 
 #endif
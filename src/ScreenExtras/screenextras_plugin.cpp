@@ -24,6 +24,15 @@
 
 #include "screenextras_plugin.h"
 #include "screen.h"
+#include "windowscreen.h"
+#include "breakpoints.h"
+#include "screengridlayout.h"
+#include "framestatistics.h"
+#include "screenimageprovider.h"
+#include "screeniconprovider.h"
+#include "assetresolver.h"
+#include "componentpreloader.h"
+#include "screentimings.h"
 
 #include <qqml.h>
 
@@ -40,7 +49,32 @@ static QObject *screenSingle(QQmlEngine *engine, QJSEngine *scriptEngine)
 
 void ScreenExtrasPlugin::registerTypes(const char *uri)
 {
+    ScreenTimingScope timing(ScreenTimings::PluginLoad);
+
     // @uri ScreenExtras
+    qRegisterMetaType<ScreenMetrics>("ScreenMetrics");
     qmlRegisterSingletonType<ScreenExtras>(uri, 1, 0, "ScreenExtras",screenSingle);
+    qmlRegisterUncreatableType<ScreenModel>(uri, 1, 0, "ScreenModel",
+                                            "ScreenModel is available through ScreenExtras.screens");
+    qmlRegisterUncreatableType<ScreenFonts>(uri, 1, 0, "ScreenFonts",
+                                            "ScreenFonts is available through ScreenExtras.fonts");
+    qmlRegisterUncreatableType<GridUnits>(uri, 1, 0, "GridUnits",
+                                          "GridUnits is available through ScreenExtras.units");
+    qmlRegisterUncreatableType<WindowScreen>(uri, 1, 0, "WindowScreen",
+                                             "WindowScreen is only available as an attached property");
+    qmlRegisterType<Breakpoints>(uri, 1, 0, "Breakpoints");
+    qmlRegisterType<ScreenGridLayout>(uri, 1, 0, "ScreenGridLayout");
+    qmlRegisterType<FrameStatistics>(uri, 1, 0, "FrameStatistics");
+    qmlRegisterType<AssetResolver>(uri, 1, 0, "AssetResolver");
+    qmlRegisterType<ComponentPreloader>(uri, 1, 0, "ComponentPreloader");
+}
+
+void ScreenExtrasPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
+{
+    Q_UNUSED(uri)
+
+    // image://screenextras/<width>x<height>/<source>, sizes in grid units
+    engine->addImageProvider(QStringLiteral("screenextras"), new ScreenImageProvider());
+    engine->addImageProvider(QStringLiteral("screenicons"), new ScreenIconProvider());
 }
 
@@ -35,6 +35,7 @@ class ScreenExtrasPlugin : public QQmlExtensionPlugin
 
 public:
     void registerTypes(const char *uri);
+    void initializeEngine(QQmlEngine *engine, const char *uri);
 };
 
 #endif // SCREENEXTRAS_PLUGIN_H
@@ -0,0 +1,786 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+
+#include "screenextrascore.h"
+#include "screenprofile.h"
+#include "screenmodel.h"
+#include "screentimings.h"
+#include <QCoreApplication>
+#include <QScreen>
+#include <QGuiApplication>
+#include <QDebug>
+#include <cmath>
+
+
+ScreenExtrasCore::ScreenExtrasCore(QObject *parent) :
+    QObject(parent),
+    m_bInitialized(false),
+    m_gridUnit(8),
+    m_snappedGridUnit(8),
+    m_pixelSnapping(qEnvironmentVariableIntValue("QMLSCREENEXTRAS_PIXEL_SNAPPING") != 0),
+    m_defaultGrid(ScreenProfile::DefaultGridUnit),
+    m_devicePixelRatio(1.0),
+    m_displayDiagonalSize(0.0),
+    m_desktopWidth(0),
+    m_desktopHeight(0),
+    m_virtualWidth(0),
+    m_virtualHeight(0),
+    m_numberOfScreens(0),
+    m_physicalDotsPerInch(96.0),
+    m_logicalDotsPerInch(96.0),
+    m_scaleSize(1.0),
+    m_formFactor("desktop"),
+    m_formFactorType(FormFactorRules::Desktop),
+    m_operatingSystem(FormFactorRules::UnknownOs),
+    m_androidDpi(),
+    m_profileFonts(),
+    m_pendingChanges(NoChange),
+    m_computed(NoChange),
+    m_fonts(new ScreenFonts(this)),
+    m_units(new GridUnits(this)),
+    m_updateDepth(0),
+    m_changedProperties(0),
+    m_screens(lazyInitialization() ? 0 : new ScreenModel(this))
+{
+    ScreenTimingScope timing(ScreenTimings::Construction);
+
+    // Hot plug events tend to come in bursts ( a dock bringing back
+    // three monitors at once ) so they are only collected here and
+    // handled once the event loop comes back around.
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, &QTimer::timeout,
+            this, &ScreenExtrasCore::processPendingChanges);
+
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
+            this, &ScreenExtrasCore::onPrimaryScreenChanged);
+    connect(qGuiApp, &QGuiApplication::screenAdded,
+            this, &ScreenExtrasCore::onScreenAdded);
+    connect(qGuiApp, &QGuiApplication::screenRemoved,
+            this, &ScreenExtrasCore::onScreenRemoved);
+
+    foreach (QScreen *screen, QGuiApplication::screens())
+        watchScreen(screen);
+
+    if (lazyInitialization())
+        m_screen = QGuiApplication::primaryScreen();
+    else
+        initialize(QGuiApplication::primaryScreen());
+
+}
+
+/*
+  Every QML engine gets its own ScreenExtras but they all wrap this one, so
+  the screens are only looked at and followed once per process. It goes
+  away together with the last ScreenExtras.
+*/
+QSharedPointer<ScreenExtrasCore> ScreenExtrasCore::instance()
+{
+    static QWeakPointer<ScreenExtrasCore> shared;
+
+    QSharedPointer<ScreenExtrasCore> core = shared.toStrongRef();
+    if (!core)
+    {
+        core = QSharedPointer<ScreenExtrasCore>(new ScreenExtrasCore());
+        shared = core;
+    }
+    return core;
+}
+
+namespace {
+// -1 until it was set or the environment was read
+int lazyInitializationMode = -1;
+}
+
+/*
+  In lazy mode the constructor only hooks up the screen signals. Geometry,
+  form factor, fonts and the screen model are each worked out the first
+  time one of their properties is read, which keeps creating the singleton
+  off the way to the first frame when a QML file only needs a few of them.
+*/
+bool ScreenExtrasCore::lazyInitialization()
+{
+    if (lazyInitializationMode < 0)
+        lazyInitializationMode = qEnvironmentVariableIntValue("QMLSCREENEXTRAS_LAZY") ? 1 : 0;
+    return lazyInitializationMode == 1;
+}
+
+void ScreenExtrasCore::setLazyInitialization(bool lazy)
+{
+    lazyInitializationMode = lazy ? 1 : 0;
+}
+
+QString ScreenExtrasCore::formFactor() const
+{
+    ensureComputed(FormFactorChange);
+    return m_formFactor;
+}
+
+FormFactorRules::Type ScreenExtrasCore::formFactorType() const
+{
+    ensureComputed(FormFactorChange);
+    return m_formFactorType;
+}
+
+
+bool ScreenExtrasCore::isInitialized()
+{
+    return m_bInitialized;
+}
+
+void ScreenExtrasCore::initialize(QScreen *screen)
+{
+    m_screen = screen;
+    m_pendingChanges = NoChange;
+    m_updateTimer.stop();
+    applyChanges(AllChanges);
+    m_bInitialized = true;
+}
+
+void ScreenExtrasCore::watchScreen(QScreen *screen)
+{
+    connect(screen, &QScreen::geometryChanged,
+            this, &ScreenExtrasCore::onScreenGeometryChanged);
+    connect(screen, &QScreen::availableGeometryChanged,
+            this, &ScreenExtrasCore::onScreenAvailableGeometryChanged);
+    connect(screen, &QScreen::physicalSizeChanged,
+            this, &ScreenExtrasCore::onScreenDensityChanged);
+    connect(screen, &QScreen::logicalDotsPerInchChanged,
+            this, &ScreenExtrasCore::onScreenDensityChanged);
+    connect(screen, &QScreen::physicalDotsPerInchChanged,
+            this, &ScreenExtrasCore::onScreenDensityChanged);
+    connect(screen, &QScreen::refreshRateChanged,
+            this, &ScreenExtrasCore::onScreenRefreshRateChanged);
+}
+
+void ScreenExtrasCore::scheduleUpdate(Changes changes)
+{
+    m_pendingChanges |= changes;
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+void ScreenExtrasCore::processPendingChanges()
+{
+    // a group that was never read is computed with fresh values when it is
+    const Changes changes = m_pendingChanges & m_computed;
+    m_pendingChanges = NoChange;
+    m_updateTimer.stop();
+
+    applyChanges(changes);
+}
+
+/*
+  A group that was never computed cannot have been read yet, so filling it
+  in does not need any NOTIFY signals. Sending them would also land in the
+  middle of the binding that asked for the value. Changes of an update that
+  is still open are put back afterwards and sent as usual.
+*/
+void ScreenExtrasCore::computeSilently(Changes groups)
+{
+    const uint outerChanges = m_changedProperties;
+    m_changedProperties = 0;
+
+    ++m_updateDepth;
+    applyChanges(groups);
+    --m_updateDepth;
+
+    m_changedProperties = outerChanges;
+    // the open update sends gridUnitChanged() for the units when it ends
+    if (!(outerChanges & GridUnitProperty))
+        m_units->setGridUnit(effectiveGridUnit(), false);
+    updateSnapshot();
+}
+
+/*
+  Recomputes only what the changes touch. The setters already skip values
+  that did not change and the fonts are only rebuilt by applyProfile() when
+  the grid unit or the form factor moved.
+*/
+void ScreenExtrasCore::applyChanges(Changes changes)
+{
+    QScreen *screen = m_screen;
+    if (!screen || !changes)
+        return;
+
+    // before the form factor, applyProfile() looks at it for the fonts
+    m_computed |= changes;
+
+    beginUpdate();
+
+    {
+        ScreenTimingScope timing(ScreenTimings::ScreenQuery);
+
+        if (changes & (DesktopGeometryChange | PrimaryScreenChange))
+        {
+            m_desktopGeometry = screen->geometry();
+            setDesktopHeight(screen->availableGeometry().height() );
+            setDesktopWidth(screen->availableGeometry().width() );
+        }
+
+        if (changes & (VirtualGeometryChange | ScreenCountChange | PrimaryScreenChange))
+        {
+            setVirtualHeight( screen->availableVirtualGeometry().height() );
+            setVirtualWidth(screen->availableVirtualGeometry().width());
+        }
+
+        if (changes & ScreenCountChange)
+            setNumberOfScreens(QGuiApplication::screens().length());
+
+        if (changes & PrimaryScreenChange)
+        {
+            setDevicePixelRatio(screen->devicePixelRatio());
+            setPrimaryScreenName(screen->name());
+            setDotsPerInch(screen->physicalDotsPerInch(), screen->logicalDotsPerInch());
+        }
+    }
+
+    if (changes & PerformanceTierChange)
+        updatePerformanceTier();
+
+    if (changes & FormFactorChange)
+        updateFormFactor();
+    else if (changes & FontsChange)
+        updateFonts();
+
+    // snapped font sizes also move with the device pixel ratio
+    if ((changes & PrimaryScreenChange) && m_pixelSnapping && (m_computed & FontsChange))
+        updateFonts();
+
+    endUpdate();
+}
+
+void ScreenExtrasCore::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void ScreenExtrasCore::endUpdate()
+{
+    Q_ASSERT(m_updateDepth > 0);
+    if (--m_updateDepth == 0)
+        flushChanges();
+}
+
+void ScreenExtrasCore::propertyChanged(Property property)
+{
+    m_changedProperties |= property;
+    if (m_updateDepth == 0)
+        flushChanges();
+}
+
+/*
+  Emits every NOTIFY signal that was held back during the update exactly
+  once, then a single metricsChanged() for bindings that only look at the
+  metrics snapshot.
+*/
+void ScreenExtrasCore::flushChanges()
+{
+    const uint changed = m_changedProperties;
+    if (!changed)
+        return;
+    m_changedProperties = 0;
+
+    ++m_metrics.generation;
+    const bool unitsChanged = m_units->setGridUnit(effectiveGridUnit(), false);
+    updateSnapshot();
+
+    if (changed & DesktopWidthProperty)
+        emit desktopWidthChanged();
+    if (changed & DesktopHeightProperty)
+        emit desktopHeightChanged();
+    if (changed & VirtualWidthProperty)
+        emit virtualWidthChanged();
+    if (changed & VirtualHeightProperty)
+        emit virtualHeightChanged();
+    if (changed & NumberOfScreensProperty)
+        emit numberOfScreensChanged();
+    if (changed & DevicePixelRatioProperty)
+        emit devicePixelRatioChanged();
+    if (changed & PrimaryScreenNameProperty)
+        emit primaryScreenNameChanged();
+    if (changed & DisplaySizeProperty)
+        emit displaySizeChanged();
+    if (changed & GridUnitProperty)
+        emit gridUnitChanged();
+    if (changed & ScaleSizeProperty)
+        emit scaleSizeChanged();
+    if (changed & FormFactorProperty)
+        emit formFactorChanged();
+    if (changed & PerformanceTierProperty)
+        emit performanceTierChanged();
+    if (changed & FontsProperty)
+        emit m_fonts->fontsChanged();
+    if (unitsChanged)
+        emit m_units->gridUnitChanged();
+
+    emit metricsChanged(m_metrics.generation);
+}
+
+void ScreenExtrasCore::updateSnapshot()
+{
+    m_metrics.desktopWidth = m_desktopWidth;
+    m_metrics.desktopHeight = m_desktopHeight;
+    m_metrics.virtualWidth = m_virtualWidth;
+    m_metrics.virtualHeight = m_virtualHeight;
+    m_metrics.numberOfScreens = m_numberOfScreens;
+    m_metrics.displaySize = m_displayDiagonalSize;
+    m_metrics.devicePixelRatio = m_devicePixelRatio;
+    m_metrics.gridUnit = effectiveGridUnit();
+    m_metrics.exactGridUnit = m_gridUnit;
+    m_metrics.scaleSize = m_scaleSize;
+    m_metrics.primaryScreenName = m_primaryScreenName;
+    m_metrics.formFactor = m_formFactor;
+    m_metrics.physicalDotsPerInch = m_physicalDotsPerInch;
+    m_metrics.logicalDotsPerInch = m_logicalDotsPerInch;
+    for (int i = 0; i < ScreenMetricsFontCount; ++i)
+        m_metrics.fontSizes[i] = m_fonts->size(i);
+
+    ScreenMetrics::publish(m_metrics);
+}
+
+ScreenMetrics ScreenExtrasCore::metrics() const
+{
+    ensureComputed(AllChanges);
+    return m_metrics;
+}
+
+int ScreenExtrasCore::generation() const
+{
+    ensureComputed(AllChanges);
+    return m_metrics.generation;
+}
+
+void ScreenExtrasCore::onPrimaryScreenChanged(QScreen *screen)
+{
+    m_screen = screen;
+    scheduleUpdate(AllChanges);
+}
+
+void ScreenExtrasCore::onScreenAdded(QScreen *screen)
+{
+    watchScreen(screen);
+    scheduleUpdate(ScreenCountChange);
+}
+
+void ScreenExtrasCore::onScreenRemoved(QScreen *screen)
+{
+    // if this was the primary screen primaryScreenChanged() follows
+    Q_UNUSED(screen)
+    scheduleUpdate(ScreenCountChange);
+}
+
+void ScreenExtrasCore::onScreenGeometryChanged()
+{
+    // iOS and Windows look at the screen size for the scale
+    if (sender() == m_screen.data())
+        scheduleUpdate(PrimaryScreenChange | FormFactorChange | PerformanceTierChange);
+}
+
+void ScreenExtrasCore::onScreenAvailableGeometryChanged()
+{
+    if (sender() == m_screen.data())
+        scheduleUpdate(DesktopGeometryChange | VirtualGeometryChange);
+    else
+        scheduleUpdate(VirtualGeometryChange);
+}
+
+void ScreenExtrasCore::onScreenDensityChanged()
+{
+    if (sender() == m_screen.data())
+        scheduleUpdate(PrimaryScreenChange | FormFactorChange | PerformanceTierChange);
+}
+
+// the probe scores the pixel throughput, which moves with the refresh rate
+void ScreenExtrasCore::onScreenRefreshRateChanged()
+{
+    if (sender() == m_screen.data())
+        scheduleUpdate(PerformanceTierChange);
+}
+
+void ScreenExtrasCore::setGridUnit(const double &unit)
+{
+    const double gridUnit = unit * m_defaultGrid;
+    if( m_gridUnit == gridUnit )
+        return;
+    m_gridUnit = gridUnit;
+    propertyChanged(GridUnitProperty);
+    updateSnappedGridUnit();
+}
+
+double ScreenExtrasCore::gridUnit() const
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange);
+    return effectiveGridUnit();
+}
+
+double ScreenExtrasCore::effectiveGridUnit() const
+{
+    return m_pixelSnapping ? m_snappedGridUnit : m_gridUnit;
+}
+
+// the grid unit rounded to whole device pixels, but never below one
+void ScreenExtrasCore::updateSnappedGridUnit()
+{
+    const double snapped = qMax(1.0, std::nearbyint(m_gridUnit * m_devicePixelRatio)) / m_devicePixelRatio;
+    if (m_snappedGridUnit == snapped)
+        return;
+    m_snappedGridUnit = snapped;
+    propertyChanged(GridUnitProperty);
+}
+
+bool ScreenExtrasCore::pixelSnapping() const
+{
+    return m_pixelSnapping;
+}
+
+void ScreenExtrasCore::setPixelSnapping(bool snapping)
+{
+    if (m_pixelSnapping == snapping)
+        return;
+    m_pixelSnapping = snapping;
+
+    beginUpdate();
+    if (m_snappedGridUnit != m_gridUnit)
+        propertyChanged(GridUnitProperty);
+    if (m_computed & FontsChange)
+        updateFonts();
+    endUpdate();
+
+    emit pixelSnappingChanged();
+}
+
+double ScreenExtrasCore::exactGridUnit() const
+{
+    ensureComputed(FormFactorChange);
+    return m_gridUnit;
+}
+
+double ScreenExtrasCore::snappedGridUnit() const
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange);
+    return m_snappedGridUnit;
+}
+
+int ScreenExtrasCore::desktopWidth() const
+{
+    ensureComputed(DesktopGeometryChange);
+    return m_desktopWidth;
+}
+
+void ScreenExtrasCore::setDesktopWidth(const int &desktopWidth)
+{
+    if(m_desktopWidth == desktopWidth)
+        return;
+    m_desktopWidth = desktopWidth;
+    propertyChanged(DesktopWidthProperty);
+}
+
+int ScreenExtrasCore::desktopHeight() const
+{
+    ensureComputed(DesktopGeometryChange);
+    return m_desktopHeight;
+}
+
+
+void ScreenExtrasCore::setDesktopHeight(const int &desktopHeight)
+{
+    if(m_desktopHeight == desktopHeight)
+        return;
+    m_desktopHeight = desktopHeight;
+    propertyChanged(DesktopHeightProperty);
+}
+
+
+int ScreenExtrasCore::virtualWidth() const
+{
+    ensureComputed(VirtualGeometryChange);
+    return m_virtualWidth;
+}
+
+void ScreenExtrasCore::setVirtualWidth(const int &virtualWidth)
+{
+    if ( m_virtualWidth == virtualWidth )
+        return;
+    m_virtualWidth = virtualWidth ;
+    propertyChanged(VirtualWidthProperty);
+}
+
+int ScreenExtrasCore::virtualHeight() const
+{
+    ensureComputed(VirtualGeometryChange);
+    return m_virtualHeight;
+}
+
+void ScreenExtrasCore::setVirtualHeight(const int &virtualHeight)
+{
+    if ( m_virtualHeight == virtualHeight )
+        return;
+    m_virtualHeight = virtualHeight ;
+    propertyChanged(VirtualHeightProperty);
+}
+
+int ScreenExtrasCore::numberOfScreens() const
+{
+    ensureComputed(ScreenCountChange);
+    return m_numberOfScreens;
+}
+
+void ScreenExtrasCore::setNumberOfScreens(const int &numberOfScreens)
+{
+    if(m_numberOfScreens == numberOfScreens)
+        return;
+    m_numberOfScreens = numberOfScreens;
+    propertyChanged(NumberOfScreensProperty);
+}
+
+
+
+double ScreenExtrasCore::displaySize() const
+{
+    ensureComputed(FormFactorChange);
+    return m_displayDiagonalSize;
+}
+
+QString ScreenExtrasCore::primaryScreenName() const
+{
+    ensureComputed(PrimaryScreenChange);
+    return  m_primaryScreenName;
+}
+
+void ScreenExtrasCore::setPrimaryScreenName(const QString &primaryScreenName)
+{
+    if(m_primaryScreenName == primaryScreenName)
+        return;
+    m_primaryScreenName = primaryScreenName;
+    propertyChanged(PrimaryScreenNameProperty);
+}
+
+// only in the metrics, so there is no signal of its own
+void ScreenExtrasCore::setDotsPerInch(double physical, double logical)
+{
+    if (m_physicalDotsPerInch == physical && m_logicalDotsPerInch == logical)
+        return;
+    m_physicalDotsPerInch = physical;
+    m_logicalDotsPerInch = logical;
+    propertyChanged(DotsPerInchProperty);
+}
+
+double ScreenExtrasCore::devicePixelRatio() const
+{
+    ensureComputed(PrimaryScreenChange);
+    return m_devicePixelRatio;
+}
+
+void ScreenExtrasCore::setDevicePixelRatio(const double &devicePixelRatio)
+{
+    if (m_devicePixelRatio == devicePixelRatio)
+        return;
+    m_devicePixelRatio = devicePixelRatio;
+    propertyChanged(DevicePixelRatioProperty);
+    updateSnappedGridUnit();
+}
+
+double ScreenExtrasCore::gu(double units)
+{
+    return m_pixelSnapping ? guSnapped(units) : guExact(units);
+}
+
+double ScreenExtrasCore::guExact(double units)
+{
+    ensureComputed(FormFactorChange);
+    return units * m_gridUnit;
+}
+
+double ScreenExtrasCore::guSnapped(double units)
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange);
+    return std::nearbyint(units * m_snappedGridUnit * m_devicePixelRatio) / m_devicePixelRatio;
+}
+
+double ScreenExtrasCore::pxToGu(double px)
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange);
+    return px / effectiveGridUnit();
+}
+
+ScreenModel *ScreenExtrasCore::screens() const
+{
+    if (!m_screens)
+        m_screens = new ScreenModel(const_cast<ScreenExtrasCore *>(this));
+    return m_screens;
+}
+
+GridUnits *ScreenExtrasCore::units() const
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange);
+    return m_units;
+}
+
+QString ScreenExtrasCore::screenNameAt(const int &screenNumber)
+{
+    return screens()->nameAt(screenNumber);
+}
+
+qreal ScreenExtrasCore::screenRefreshRateAt(const int &screenNumber)
+{
+    return screens()->refreshRateAt(screenNumber);
+}
+
+double ScreenExtrasCore::font(int fontSize)
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange | FontsChange);
+    return m_fonts->size(fontSize);
+}
+
+ScreenFonts *ScreenExtrasCore::fonts() const
+{
+    ensureComputed(FormFactorChange | PrimaryScreenChange | FontsChange);
+    return m_fonts;
+}
+
+void ScreenExtrasCore::applyProfile(const ScreenProfile &profile)
+{
+    const QString oldFormFactor = m_formFactor;
+    const FormFactorRules::OperatingSystem oldOperatingSystem = m_operatingSystem;
+    const double oldGridUnit = effectiveGridUnit();
+    const double oldDiagonal = m_displayDiagonalSize;
+    const QVector<double> oldProfileFonts = m_profileFonts;
+
+    m_systemType = profile.systemType;
+    m_operatingSystem = profile.os;
+    m_displayDiagonalSize = profile.diagonal;
+    m_androidDpi = profile.androidDpi;
+    m_formFactor = profile.formFactor;
+    m_formFactorType = profile.type;
+    m_profileFonts = profile.fontSizes;
+
+    setGridUnit(profile.scaleSize);
+    setScaleSize(profile.scaleSize);
+
+    if (m_displayDiagonalSize != oldDiagonal)
+        propertyChanged(DisplaySizeProperty);
+
+    if (m_formFactor != oldFormFactor)
+        propertyChanged(FormFactorProperty);
+
+    // the fonts only depend on these
+    if (!(m_computed & FontsChange))
+        return;
+    if (m_fonts->isEmpty()
+            || m_formFactor != oldFormFactor
+            || m_operatingSystem != oldOperatingSystem
+            || effectiveGridUnit() != oldGridUnit
+            || m_profileFonts != oldProfileFonts)
+    {
+        updateFonts();
+    }
+}
+
+void ScreenExtrasCore::updateFormFactor()
+{
+    if (!m_screen)
+        return;
+
+    const ScreenProfile profile = ScreenProfile::forScreen(m_screen);
+    if (!profile.isValid)
+    {
+        // still hand out the default font sizes
+        if ((m_computed & FontsChange) && m_fonts->isEmpty())
+            updateFonts();
+        return;
+    }
+
+    applyProfile(profile);
+}
+
+double ScreenExtrasCore::scaleSize() const
+{
+    ensureComputed(FormFactorChange);
+    return m_scaleSize;
+}
+
+void ScreenExtrasCore::setScaleSize(const double &size)
+{
+    if( m_scaleSize == size) return;
+    m_scaleSize = size;
+    propertyChanged(ScaleSizeProperty);
+}
+
+void ScreenExtrasCore::updateFonts()
+{
+    ScreenTimingScope timing(ScreenTimings::Fonts);
+
+    double sizes[FontTable::FontCount];
+    if (m_profileFonts.size() == FontTable::FontCount)
+    {
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = m_profileFonts.at(i);
+    }
+    else
+    {
+        const double *units = FontTable::units(m_formFactorType, m_operatingSystem);
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = units[i] * effectiveGridUnit();
+    }
+
+    if (m_pixelSnapping)
+    {
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = std::nearbyint(sizes[i] * m_devicePixelRatio) / m_devicePixelRatio;
+    }
+
+    // fontsChanged() goes out with the other signals in flushChanges()
+    if (m_fonts->setSizes(sizes, false))
+    {
+        propertyChanged(FontsProperty);
+    }
+}
+
+/*
+  The probe reads /proc or asks the OS for the memory once per process, after
+  that only the pixel load of the primary screen is looked at again.
+*/
+void ScreenExtrasCore::updatePerformanceTier()
+{
+    const DeviceCapabilities capabilities = DeviceCapabilities::probe(m_screen);
+    if (capabilities.toVariantMap() == m_capabilities.toVariantMap())
+        return;
+
+    m_capabilities = capabilities;
+    propertyChanged(PerformanceTierProperty);
+}
+
+QString ScreenExtrasCore::performanceTier() const
+{
+    ensureComputed(PerformanceTierChange);
+    return DeviceCapabilities::tierName(m_capabilities.tier());
+}
+
+QVariantMap ScreenExtrasCore::deviceCapabilities() const
+{
+    ensureComputed(PerformanceTierChange);
+    return m_capabilities.toVariantMap();
+}
@@ -0,0 +1,273 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENEXTRASCORE_H
+#define SCREENEXTRASCORE_H
+
+#include <QObject>
+#include <QScreen>
+#include <QString>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QVector>
+
+#include "screenmetrics.h"
+#include "screenmodel.h"
+#include "screenfonts.h"
+#include "gridunits.h"
+#include "formfactor.h"
+#include "deviceprobe.h"
+
+struct ScreenProfile;
+
+/*
+  Everything ScreenExtras knows about the screens. There is one of these
+  per process, shared by the ScreenExtras singletons of all QML engines,
+  which only pass its signals on.
+*/
+class ScreenExtrasCore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScreenExtrasCore( QObject *parent = 0 );
+
+    static QSharedPointer<ScreenExtrasCore> instance();
+
+    QString formFactor() const;
+    FormFactorRules::Type formFactorType() const;
+
+    // What needs to be recomputed after the screens changed
+    enum Change
+    {
+        NoChange = 0x00,
+        DesktopGeometryChange = 0x01,
+        VirtualGeometryChange = 0x02,
+        ScreenCountChange = 0x04,
+        PrimaryScreenChange = 0x08,
+        FormFactorChange = 0x10,
+        FontsChange = 0x20,
+        PerformanceTierChange = 0x40,
+        AllChanges = 0x7f
+    };
+    Q_DECLARE_FLAGS(Changes, Change)
+
+    // has to be set before the core is created
+    static bool lazyInitialization();
+    static void setLazyInitialization(bool lazy);
+
+    double gridUnit()const;
+    void setGridUnit(const double &unit);
+
+    // gridUnit, gu() and the fonts land on whole device pixels while this is on
+    bool pixelSnapping() const;
+    void setPixelSnapping(bool snapping);
+    double exactGridUnit() const;
+    double snappedGridUnit() const;
+
+    double scaleSize()const;
+    void setScaleSize(const double &size);
+
+    int desktopWidth() const;
+    void setDesktopWidth(const int &desktopWidth);
+
+    int desktopHeight() const;
+    void setDesktopHeight(const int &desktopHeight);
+
+    int virtualWidth() const;
+    void setVirtualWidth(const int &designWidth);
+
+    int virtualHeight() const;
+    void setVirtualHeight(const int &designHeight);
+
+    int numberOfScreens()const;
+    void setNumberOfScreens(const int &numberOfScreens);
+
+    double displaySize()const;
+
+    QString primaryScreenName()const;
+    void setPrimaryScreenName(const QString &primaryScreenName);
+
+    double devicePixelRatio()const;
+    void setDevicePixelRatio(const double &devicePixelRatio);
+
+    ScreenMetrics metrics() const;
+    int generation() const;
+
+    ScreenModel *screens() const;
+
+    double gu(double units);
+    double guExact(double units);
+    double guSnapped(double units);
+    double pxToGu(double px);
+    QString screenNameAt(const int &screenNumber);
+    qreal screenRefreshRateAt(const int &screenNumber);
+    double font(int fontSize);
+
+    ScreenFonts *fonts() const;
+    GridUnits *units() const;
+
+    QString performanceTier() const;
+    QVariantMap deviceCapabilities() const;
+
+
+protected:
+    // internal
+
+
+    void applyProfile(const ScreenProfile &profile);
+
+    void updateFormFactor();
+    void updateFonts();
+    void updatePerformanceTier();
+    bool isInitialized();
+
+    void watchScreen(QScreen *screen);
+    void scheduleUpdate(Changes changes);
+
+    // in lazy mode a group is only computed the first time it is read
+    inline void ensureComputed(Changes groups) const;
+    void computeSilently(Changes groups);
+    void applyChanges(Changes changes);
+
+    // setters called between these only notify once in endUpdate()
+    void beginUpdate();
+    void endUpdate();
+
+protected slots:
+     void initialize(QScreen *screen);
+     void processPendingChanges();
+
+     void onPrimaryScreenChanged(QScreen *screen);
+     void onScreenAdded(QScreen *screen);
+     void onScreenRemoved(QScreen *screen);
+     void onScreenGeometryChanged();
+     void onScreenAvailableGeometryChanged();
+     void onScreenDensityChanged();
+     void onScreenRefreshRateChanged();
+
+signals:
+    void gridUnitChanged();
+    void scaleSizeChanged();
+    void formFactorChanged();
+    void displaySizeChanged();
+    void devicePixelRatioChanged();
+
+    void desktopWidthChanged();
+    void desktopHeightChanged();
+    void virtualWidthChanged();
+    void virtualHeightChanged();
+    void numberOfScreensChanged();
+    void primaryScreenNameChanged();
+
+    void metricsChanged(int generation);
+    void pixelSnappingChanged();
+    void performanceTierChanged();
+
+private:
+    enum Property
+    {
+        GridUnitProperty = 0x001,
+        ScaleSizeProperty = 0x002,
+        FormFactorProperty = 0x004,
+        DisplaySizeProperty = 0x008,
+        DevicePixelRatioProperty = 0x010,
+        DesktopWidthProperty = 0x020,
+        DesktopHeightProperty = 0x040,
+        VirtualWidthProperty = 0x080,
+        VirtualHeightProperty = 0x100,
+        NumberOfScreensProperty = 0x200,
+        PrimaryScreenNameProperty = 0x400,
+        FontsProperty = 0x800,
+        DotsPerInchProperty = 0x1000,
+        PerformanceTierProperty = 0x2000
+    };
+
+    void propertyChanged(Property property);
+    void flushChanges();
+    void updateSnapshot();
+    void setDotsPerInch(double physical, double logical);
+    void updateSnappedGridUnit();
+    double effectiveGridUnit() const;
+
+    bool m_bInitialized;
+
+    double m_gridUnit;
+    double m_snappedGridUnit;
+    bool m_pixelSnapping;
+    double m_defaultGrid;
+    double m_devicePixelRatio;
+    double m_displayDiagonalSize;
+
+
+    int m_desktopWidth;
+    int m_desktopHeight;
+    int m_virtualWidth;
+    int m_virtualHeight;
+
+    int m_numberOfScreens;
+
+    QRect m_desktopGeometry;
+
+    double m_physicalDotsPerInch;
+    double m_logicalDotsPerInch;
+    double m_scaleSize;
+
+    QString m_formFactor;
+    FormFactorRules::Type m_formFactorType;
+    FormFactorRules::OperatingSystem m_operatingSystem;
+    QString m_androidDpi;
+    // font sizes pinned in the profile cache, if any
+    QVector<double> m_profileFonts;
+
+    DeviceCapabilities m_capabilities;
+
+    QString m_systemType;
+    QString m_primaryScreenName;
+
+    QPointer<QScreen> m_screen;
+    Changes m_pendingChanges;
+    Changes m_computed;
+    QTimer m_updateTimer;
+
+    ScreenFonts *m_fonts;
+    GridUnits *m_units;
+
+    int m_updateDepth;
+    uint m_changedProperties;
+    ScreenMetrics m_metrics;
+
+    mutable ScreenModel *m_screens;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ScreenExtrasCore::Changes)
+
+inline void ScreenExtrasCore::ensureComputed(Changes groups) const
+{
+    if ((m_computed & groups) != groups)
+        const_cast<ScreenExtrasCore *>(this)->computeSilently(groups & ~m_computed);
+}
+
+#endif // SCREENEXTRASCORE_H
@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screenfonts.h"
+
+namespace FontTable
+{
+
+namespace
+{
+
+struct Row
+{
+    // NOTSET, XXLARGE, XLARGE, LARGE, MEDIUM, NORMAL, SMALL, TINY
+    double units[FontCount];
+};
+
+constexpr Row Desktop = { { 0, 5, 4.7, 4, 3.5, 2.5, 2, 1.2 } };
+constexpr Row Tv = { { 0, 10, 8, 6, 4.5, 3.5, 3, 2 } };
+constexpr Row Tablet = Desktop;
+constexpr Row IosPhone = { { 0, 5, 4.6, 3.0, 2.8, 2.0, 1.5, .5 } };
+constexpr Row AndroidPhone = { { 0, 6, 5.6, 4.3, 3.8, 3.0, 2.5, 1.2 } };
+
+// [form factor][operating system]
+// Only iOS gets the iOS phone sizes, every other OS and phablets use the
+// phone row of their OS until they get sizes of their own
+// UnknownOs, Ios, Android, Windows, WinPhone, MacOs, Linux
+constexpr Row table[FormFactorRules::TypeCount][FormFactorRules::OperatingSystemCount] =
+{
+    // Desktop
+    { Desktop, Desktop, Desktop, Desktop, Desktop, Desktop, Desktop },
+    // Tv
+    { Tv, Tv, Tv, Tv, Tv, Tv, Tv },
+    // Phablet
+    { AndroidPhone, IosPhone, AndroidPhone, AndroidPhone, AndroidPhone, AndroidPhone, AndroidPhone },
+    // Tablet
+    { Tablet, Tablet, Tablet, Tablet, Tablet, Tablet, Tablet },
+    // Phone
+    { AndroidPhone, IosPhone, AndroidPhone, AndroidPhone, AndroidPhone, AndroidPhone, AndroidPhone }
+};
+
+} // namespace
+
+const double *units(FormFactorRules::Type type, FormFactorRules::OperatingSystem os)
+{
+    return table[type][os].units;
+}
+
+} // namespace FontTable
+
+/*!
+   \qmltype ScreenFonts
+   \inqmlmodule QmlScreenExtras
+   \brief The font sizes for the form factor, see ScreenExtras::fonts
+
+   These hold the same values as ScreenExtras::font() but as properties, so they are
+   only read once per change instead of calling font() in every binding.
+
+     \code
+     Text{
+        font.pixelSize: ScreenExtras.fonts.normal
+     }
+     \endcode
+*/
+
+ScreenFonts::ScreenFonts(QObject *parent) :
+    QObject(parent)
+{
+    for (int i = 0; i < FontTable::FontCount; ++i)
+        m_sizes[i] = 0.0;
+}
+
+double ScreenFonts::xxlarge() const
+{
+    return m_sizes[1];
+}
+
+double ScreenFonts::xlarge() const
+{
+    return m_sizes[2];
+}
+
+double ScreenFonts::large() const
+{
+    return m_sizes[3];
+}
+
+double ScreenFonts::medium() const
+{
+    return m_sizes[4];
+}
+
+double ScreenFonts::normal() const
+{
+    return m_sizes[5];
+}
+
+double ScreenFonts::small() const
+{
+    return m_sizes[6];
+}
+
+double ScreenFonts::tiny() const
+{
+    return m_sizes[7];
+}
+
+double ScreenFonts::size(int font) const
+{
+    if (font < 0 || font >= FontTable::FontCount)
+        return 0.0;
+    return m_sizes[font];
+}
+
+bool ScreenFonts::isEmpty() const
+{
+    return m_sizes[1] == 0.0;
+}
+
+bool ScreenFonts::setSizes(const double *sizes, bool notify)
+{
+    bool changed = false;
+    for (int i = 0; i < FontTable::FontCount; ++i)
+    {
+        const double size = sizes[i];
+        if (m_sizes[i] != size)
+        {
+            m_sizes[i] = size;
+            changed = true;
+        }
+    }
+
+    if (changed && notify)
+        emit fontsChanged();
+    return changed;
+}
@@ -0,0 +1,83 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENFONTS_H
+#define SCREENFONTS_H
+
+#include <QObject>
+
+#include "formfactor.h"
+#include "screenmetrics.h"
+
+namespace FontTable
+{
+
+// One entry for every ScreenExtras::Font, NOTSET included
+enum { FontCount = ScreenMetricsFontCount };
+
+// Grid units for every font, NOTSET is always 0
+const double *units(FormFactorRules::Type type, FormFactorRules::OperatingSystem os);
+
+} // namespace FontTable
+
+// The pixel sizes of the fonts for one screen, worked out once per change
+class ScreenFonts : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY( double xxlarge READ xxlarge NOTIFY fontsChanged )
+    Q_PROPERTY( double xlarge READ xlarge NOTIFY fontsChanged )
+    Q_PROPERTY( double large READ large NOTIFY fontsChanged )
+    Q_PROPERTY( double medium READ medium NOTIFY fontsChanged )
+    Q_PROPERTY( double normal READ normal NOTIFY fontsChanged )
+    Q_PROPERTY( double small READ small NOTIFY fontsChanged )
+    Q_PROPERTY( double tiny READ tiny NOTIFY fontsChanged )
+
+public:
+    explicit ScreenFonts( QObject *parent = 0 );
+
+    double xxlarge() const;
+    double xlarge() const;
+    double large() const;
+    double medium() const;
+    double normal() const;
+    double small() const;
+    double tiny() const;
+
+    double size(int font) const;
+    bool isEmpty() const;
+
+    // FontTable::FontCount pixel sizes, NOTSET first. Returns true and emits
+    // fontsChanged() when any size changed, without notify the caller emits
+    // it once its own update is done
+    bool setSizes(const double *sizes, bool notify = true);
+
+signals:
+    void fontsChanged();
+
+private:
+    double m_sizes[FontTable::FontCount];
+};
+
+#endif // SCREENFONTS_H
@@ -0,0 +1,492 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screengridlayout.h"
+#include "windowscreen.h"
+#include <QQuickWindow>
+#include <qqml.h>
+
+ScreenGridLayoutAttached::ScreenGridLayoutAttached(QObject *attachee) :
+    QObject(attachee),
+    m_columnSpan(1)
+{
+}
+
+/*!
+ \qmlattachedproperty int ScreenGridLayout::columnSpan
+    How many columns the item takes, 1 by default. An item that does not fit into what
+    is left of a row starts the next one.
+ */
+int ScreenGridLayoutAttached::columnSpan() const
+{
+    return m_columnSpan;
+}
+
+void ScreenGridLayoutAttached::setColumnSpan(int span)
+{
+    if (m_columnSpan == span)
+        return;
+    m_columnSpan = span;
+
+    QQuickItem *item = qobject_cast<QQuickItem *>(parent());
+    if (item)
+    {
+        if (ScreenGridLayout *layout = qobject_cast<ScreenGridLayout *>(item->parentItem()))
+            layout->invalidateItem(item);
+    }
+    emit columnSpanChanged();
+}
+
+/*!
+   \qmltype ScreenGridLayout
+   \inqmlmodule QmlScreenExtras
+   \brief Places its children in a grid of columns measured in grid units
+
+   The children are put into the columns from left to right and into rows from top to
+   bottom, the same as a Flow that knows about grid units. The number of columns can
+   be different for every form factor and the spacing and row height are in grid units
+   of the screen of the window.
+
+   Everything is worked out in C++ once per frame. A resize only moves the children
+   sideways, and when a child changes its height or span only its row and the rows
+   below it are laid out again. This is a lot cheaper than thousands of anchors or
+   x/y bindings on ScreenExtras.gu().
+
+     \code
+     ScreenGridLayout {
+        width: parent.width
+        columns: 12
+        formFactorColumns: ({ "phone": 4, "tablet": 8 })
+        spacing: 1
+        rowHeight: 10
+
+        Repeater {
+            model: tiles
+            Tile { ScreenGridLayout.columnSpan: model.wide ? 2 : 1 }
+        }
+     }
+     \endcode
+
+   With a rowHeight of 0 every row is as high as the highest implicitHeight in it.
+   The implicitHeight of the layout is the height of all rows.
+*/
+
+ScreenGridLayout::ScreenGridLayout(QQuickItem *parent) :
+    QQuickItem(parent),
+    m_columns(12),
+    m_effectiveColumns(12),
+    m_spacing(1.0),
+    m_rowHeight(0.0),
+    m_gridUnit(8),
+    m_childrenDirty(true),
+    m_widthDirty(false),
+    m_firstDirtyRow(0)
+{
+}
+
+ScreenGridLayoutAttached *ScreenGridLayout::qmlAttachedProperties(QObject *object)
+{
+    return new ScreenGridLayoutAttached(object);
+}
+
+/*!
+ \qmlproperty int ScreenGridLayout::columns
+    The number of columns for form factors that are not in formFactorColumns, 12 by default.
+ */
+int ScreenGridLayout::columns() const
+{
+    return m_columns;
+}
+
+void ScreenGridLayout::setColumns(int columns)
+{
+    if (m_columns == columns)
+        return;
+    m_columns = columns;
+    updateEffectiveColumns();
+    invalidateFromRow(0);
+    emit columnsChanged();
+}
+
+/*!
+ \qmlproperty object ScreenGridLayout::formFactorColumns
+    The number of columns by form factor, the others use columns.
+ */
+QVariantMap ScreenGridLayout::formFactorColumns() const
+{
+    return m_formFactorColumns;
+}
+
+void ScreenGridLayout::setFormFactorColumns(const QVariantMap &columns)
+{
+    if (m_formFactorColumns == columns)
+        return;
+    m_formFactorColumns = columns;
+    updateEffectiveColumns();
+    invalidateFromRow(0);
+    emit columnsChanged();
+}
+
+/*!
+ \qmlproperty int ScreenGridLayout::effectiveColumns
+    The number of columns that is used for the form factor of the screen of the window.
+ */
+int ScreenGridLayout::effectiveColumns() const
+{
+    return m_effectiveColumns;
+}
+
+/*!
+ \qmlproperty double ScreenGridLayout::spacing
+    The space between the columns and between the rows in grid units, 1 by default.
+ */
+double ScreenGridLayout::spacing() const
+{
+    return m_spacing;
+}
+
+void ScreenGridLayout::setSpacing(double spacing)
+{
+    if (m_spacing == spacing)
+        return;
+    m_spacing = spacing;
+    invalidateFromRow(0);
+    emit spacingChanged();
+}
+
+/*!
+ \qmlproperty double ScreenGridLayout::rowHeight
+    The height of every row in grid units. With 0, the default, each row is as high as
+    the highest implicitHeight of its children.
+ */
+double ScreenGridLayout::rowHeight() const
+{
+    return m_rowHeight;
+}
+
+void ScreenGridLayout::setRowHeight(double rowHeight)
+{
+    if (m_rowHeight == rowHeight)
+        return;
+    m_rowHeight = rowHeight;
+    invalidateFromRow(0);
+    emit rowHeightChanged();
+}
+
+/*!
+ \qmlproperty int ScreenGridLayout::rowCount
+    The number of rows the children take up.
+ */
+int ScreenGridLayout::rowCount() const
+{
+    return m_rows.size();
+}
+
+/*!
+ \qmlmethod ScreenGridLayout::forceLayout()
+    Lays out the children right away instead of before the next frame.
+ */
+void ScreenGridLayout::forceLayout()
+{
+    if (isComponentComplete())
+        updatePolish();
+}
+
+void ScreenGridLayout::invalidateItem(QQuickItem *item)
+{
+    const int index = m_cellOfItem.value(item, -1);
+    if (index < 0)
+    {
+        m_childrenDirty = true;
+        polish();
+        return;
+    }
+
+    // a first cell that got narrower may fit at the end of the row above now
+    Cell &cell = m_cells[index];
+    const int span = spanOf(item);
+    const int row = cell.column == 0 && span < cell.span ? cell.row - 1 : cell.row;
+    cell.span = span;
+    invalidateFromRow(row);
+}
+
+void ScreenGridLayout::componentComplete()
+{
+    QQuickItem::componentComplete();
+    if (!m_tracker)
+        setTracker(WindowScreenTracker::forWindow(window()));
+    polish();
+}
+
+void ScreenGridLayout::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    switch (change)
+    {
+    case ItemChildAddedChange:
+        connect(value.item, &QQuickItem::implicitHeightChanged,
+                this, &ScreenGridLayout::onChildChanged);
+        connect(value.item, &QQuickItem::visibleChanged,
+                this, &ScreenGridLayout::onChildChanged);
+        m_childrenDirty = true;
+        polish();
+        break;
+    case ItemChildRemovedChange:
+        disconnect(value.item, 0, this, 0);
+        m_childrenDirty = true;
+        polish();
+        break;
+    case ItemSceneChange:
+        setTracker(WindowScreenTracker::forWindow(value.window));
+        break;
+    default:
+        break;
+    }
+
+    QQuickItem::itemChange(change, value);
+}
+
+void ScreenGridLayout::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+
+    // the rows stay the same, only the columns get wider or narrower
+    if (newGeometry.width() != oldGeometry.width())
+    {
+        m_widthDirty = true;
+        polish();
+    }
+}
+
+void ScreenGridLayout::onScreenChanged()
+{
+    if (m_tracker)
+        m_gridUnit = m_tracker->gridUnit();
+    updateEffectiveColumns();
+    invalidateFromRow(0);
+}
+
+void ScreenGridLayout::onChildChanged()
+{
+    QQuickItem *item = qobject_cast<QQuickItem *>(sender());
+    if (!item)
+        return;
+
+    // a hidden child leaves its cell, a shown one takes one
+    if (item->isVisible() != m_cellOfItem.contains(item))
+    {
+        m_childrenDirty = true;
+        polish();
+        return;
+    }
+
+    if (m_rowHeight <= 0.0)
+        invalidateItem(item);
+}
+
+void ScreenGridLayout::setTracker(WindowScreenTracker *tracker)
+{
+    if (m_tracker == tracker)
+        return;
+    if (m_tracker)
+        disconnect(m_tracker, 0, this, 0);
+
+    m_tracker = tracker;
+    connect(m_tracker, &WindowScreenTracker::changed,
+            this, &ScreenGridLayout::onScreenChanged);
+    onScreenChanged();
+}
+
+void ScreenGridLayout::updateEffectiveColumns()
+{
+    int columns = m_columns;
+    if (m_tracker)
+    {
+        const QVariant forFormFactor = m_formFactorColumns.value(m_tracker->profile().formFactor);
+        if (forFormFactor.isValid())
+            columns = forFormFactor.toInt();
+    }
+    columns = qMax(1, columns);
+
+    if (m_effectiveColumns == columns)
+        return;
+    m_effectiveColumns = columns;
+    emit effectiveColumnsChanged();
+}
+
+void ScreenGridLayout::invalidateFromRow(int row)
+{
+    row = qBound(0, row, qMax(0, m_rows.size() - 1));
+    m_firstDirtyRow = m_firstDirtyRow < 0 ? row : qMin(m_firstDirtyRow, row);
+    polish();
+}
+
+int ScreenGridLayout::spanOf(QQuickItem *item) const
+{
+    ScreenGridLayoutAttached *attached = qobject_cast<ScreenGridLayoutAttached *>(
+                qmlAttachedPropertiesObject<ScreenGridLayout>(item, false));
+    return attached ? attached->columnSpan() : 1;
+}
+
+/*
+  Brings the cells up to date with the visible children. Children are
+  mostly added and removed at the end, so everything in front of the first
+  difference keeps its cell and its row.
+*/
+void ScreenGridLayout::syncCells()
+{
+    m_childrenDirty = false;
+
+    QVector<QQuickItem *> items;
+    const QList<QQuickItem *> children = childItems();
+    items.reserve(children.size());
+    foreach (QQuickItem *child, children)
+    {
+        // a Repeater is an item too but never takes a cell
+        if (child->isVisible() && !child->inherits("QQuickRepeater"))
+            items.append(child);
+    }
+
+    int same = 0;
+    while (same < items.size() && same < m_cells.size() && m_cells.at(same).item == items.at(same))
+        ++same;
+
+    if (same == items.size() && same == m_cells.size())
+        return;
+
+    for (int i = same; i < m_cells.size(); ++i)
+        m_cellOfItem.remove(m_cells.at(i).item);
+
+    int firstRow = same < m_cells.size() ? m_cells.at(same).row
+                                         : (same > 0 ? m_cells.at(same - 1).row : 0);
+    // so may whatever comes in place of a first cell
+    if (same < m_cells.size() && m_cells.at(same).column == 0)
+        --firstRow;
+    m_cells.resize(same);
+
+    for (int i = same; i < items.size(); ++i)
+    {
+        Cell cell;
+        cell.item = items.at(i);
+        cell.row = -1;
+        cell.column = 0;
+        cell.span = spanOf(cell.item);
+        m_cells.append(cell);
+        m_cellOfItem.insert(cell.item, i);
+    }
+
+    invalidateFromRow(firstRow);
+}
+
+void ScreenGridLayout::updatePolish()
+{
+    if (m_childrenDirty)
+        syncCells();
+
+    const int rowCount = m_rows.size();
+
+    if (m_firstDirtyRow >= 0)
+        reflow();
+
+    // a resize keeps every child in its row and column
+    if (m_widthDirty)
+    {
+        m_widthDirty = false;
+        placeColumns(0);
+    }
+
+    if (m_rows.size() != rowCount)
+        emit rowCountChanged();
+}
+
+void ScreenGridLayout::reflow()
+{
+    const int columns = m_effectiveColumns;
+    const double spacing = m_spacing * m_gridUnit;
+    const double fixedHeight = m_rowHeight * m_gridUnit;
+
+    int row = qMin(m_firstDirtyRow, m_rows.size());
+    m_firstDirtyRow = -1;
+
+    const int first = row < m_rows.size() ? m_rows.at(row).firstCell : 0;
+    if (row >= m_rows.size())
+        row = 0;
+
+    double y = row > 0 ? m_rows.at(row - 1).y + m_rows.at(row - 1).height + spacing : 0.0;
+    m_rows.resize(row);
+
+    int column = columns;
+    for (int i = first; i < m_cells.size(); ++i)
+    {
+        Cell &cell = m_cells[i];
+        const int span = qBound(1, cell.span, columns);
+
+        if (column + span > columns)
+        {
+            if (!m_rows.isEmpty() && i > first)
+                y += m_rows.last().height + spacing;
+
+            Row next;
+            next.firstCell = i;
+            next.y = y;
+            next.height = fixedHeight;
+            m_rows.append(next);
+            column = 0;
+        }
+
+        Row &current = m_rows.last();
+        if (fixedHeight <= 0.0)
+            current.height = qMax(current.height, cell.item->implicitHeight());
+
+        cell.row = m_rows.size() - 1;
+        cell.column = column;
+        column += span;
+    }
+
+    for (int i = first; i < m_cells.size(); ++i)
+    {
+        const Cell &cell = m_cells.at(i);
+        const Row &cellRow = m_rows.at(cell.row);
+        cell.item->setY(cellRow.y);
+        cell.item->setHeight(cellRow.height);
+    }
+
+    placeColumns(first);
+
+    setImplicitHeight(m_rows.isEmpty() ? 0.0 : m_rows.last().y + m_rows.last().height);
+}
+
+void ScreenGridLayout::placeColumns(int firstCell)
+{
+    const int columns = m_effectiveColumns;
+    const double spacing = m_spacing * m_gridUnit;
+    const double columnWidth = qMax(0.0, (width() - spacing * (columns - 1)) / columns);
+
+    for (int i = firstCell; i < m_cells.size(); ++i)
+    {
+        const Cell &cell = m_cells.at(i);
+        const int span = qBound(1, cell.span, columns);
+        cell.item->setX(cell.column * (columnWidth + spacing));
+        cell.item->setWidth(span * columnWidth + (span - 1) * spacing);
+    }
+}
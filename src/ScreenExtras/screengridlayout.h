@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+
+#ifndef SCREENGRIDLAYOUT_H
+#define SCREENGRIDLAYOUT_H
+
+#include <QHash>
+#include <QPointer>
+#include <QQuickItem>
+#include <QVariantMap>
+#include <QVector>
+
+class WindowScreenTracker;
+
+// columnSpan of one child, attached to the children of a ScreenGridLayout
+class ScreenGridLayoutAttached : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY( int columnSpan READ columnSpan WRITE setColumnSpan NOTIFY columnSpanChanged )
+
+public:
+    explicit ScreenGridLayoutAttached( QObject *attachee );
+
+    int columnSpan() const;
+    void setColumnSpan(int span);
+
+signals:
+    void columnSpanChanged();
+
+private:
+    int m_columnSpan;
+};
+
+// Places its children in a column grid measured in grid units
+class ScreenGridLayout : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY( int columns READ columns WRITE setColumns NOTIFY columnsChanged )
+    Q_PROPERTY( QVariantMap formFactorColumns READ formFactorColumns WRITE setFormFactorColumns NOTIFY columnsChanged )
+    Q_PROPERTY( int effectiveColumns READ effectiveColumns NOTIFY effectiveColumnsChanged )
+    Q_PROPERTY( double spacing READ spacing WRITE setSpacing NOTIFY spacingChanged )
+    Q_PROPERTY( double rowHeight READ rowHeight WRITE setRowHeight NOTIFY rowHeightChanged )
+    Q_PROPERTY( int rowCount READ rowCount NOTIFY rowCountChanged )
+
+public:
+    explicit ScreenGridLayout( QQuickItem *parent = 0 );
+
+    static ScreenGridLayoutAttached *qmlAttachedProperties(QObject *object);
+
+    int columns() const;
+    void setColumns(int columns);
+
+    QVariantMap formFactorColumns() const;
+    void setFormFactorColumns(const QVariantMap &columns);
+
+    int effectiveColumns() const;
+
+    double spacing() const;
+    void setSpacing(double spacing);
+
+    double rowHeight() const;
+    void setRowHeight(double rowHeight);
+
+    int rowCount() const;
+
+    Q_INVOKABLE void forceLayout();
+
+    // called by the attached object of a child
+    void invalidateItem(QQuickItem *item);
+
+signals:
+    void columnsChanged();
+    void effectiveColumnsChanged();
+    void spacingChanged();
+    void rowHeightChanged();
+    void rowCountChanged();
+
+protected:
+    void componentComplete();
+    void itemChange(ItemChange change, const ItemChangeData &value);
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+    void updatePolish();
+
+protected slots:
+    void onScreenChanged();
+    void onChildChanged();
+
+private:
+    struct Cell
+    {
+        QQuickItem *item;
+        int row;
+        int column;
+        int span;
+    };
+
+    struct Row
+    {
+        int firstCell;
+        double y;
+        double height;
+    };
+
+    void setTracker(WindowScreenTracker *tracker);
+    void updateEffectiveColumns();
+    void syncCells();
+    void invalidateFromRow(int row);
+    void reflow();
+    void placeColumns(int firstCell);
+    int spanOf(QQuickItem *item) const;
+
+    int m_columns;
+    QVariantMap m_formFactorColumns;
+    int m_effectiveColumns;
+    double m_spacing;
+    double m_rowHeight;
+    double m_gridUnit;
+
+    QPointer<WindowScreenTracker> m_tracker;
+
+    QVector<Cell> m_cells;
+    QHash<QQuickItem *, int> m_cellOfItem;
+    QVector<Row> m_rows;
+
+    // what updatePolish() still has to do
+    bool m_childrenDirty;
+    bool m_widthDirty;
+    int m_firstDirtyRow;
+};
+
+QML_DECLARE_TYPEINFO(ScreenGridLayout, QML_HAS_ATTACHED_PROPERTIES)
+
+#endif // SCREENGRIDLAYOUT_H
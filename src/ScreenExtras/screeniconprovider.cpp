@@ -0,0 +1,413 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screeniconprovider.h"
+#include "screenimageprovider.h"
+#include "screenmetrics.h"
+#include "screentimings.h"
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace {
+
+// MB of rasterized icons kept in memory and on disk
+enum { MemoryCacheSize = 32, DiskCacheSize = 64 };
+
+// in front of the pixels of every file in the disk cache
+struct IconFileHeader
+{
+    quint32 magic;
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 format;
+};
+
+enum { IconFileMagic = 0x49455351, IconFileVersion = 1 };
+
+struct CachedIcon
+{
+    QImage image;
+    // what was asked for, in grid units or logical pixels
+    QSizeF size;
+    bool inGridUnits;
+    // what that came to in device pixels
+    QSize box;
+};
+
+QSize deviceBox(const QSizeF &size, bool inGridUnits, const ScreenMetrics &metrics)
+{
+    const double scale = (inGridUnits ? metrics.gridUnit : 1.0) * metrics.devicePixelRatio;
+    return QSize(qRound(size.width() * scale), qRound(size.height() * scale));
+}
+
+/*
+  Shared by every window and engine. The icons are kept premultiplied, the
+  format the scene graph uploads without converting, and the ones that came
+  from the disk cache point straight into the mapped file.
+*/
+struct IconCache
+{
+    IconCache() :
+        icons(MemoryCacheSize * 1024),
+        gridUnit(0.0),
+        devicePixelRatio(0.0),
+        diskSize(-1)
+    {
+        const QString fromEnvironment = QString::fromLocal8Bit(qgetenv("QMLSCREENEXTRAS_ICON_CACHE"));
+        if (fromEnvironment == QLatin1String("off"))
+            return;
+
+        if (!fromEnvironment.isEmpty())
+        {
+            directory = fromEnvironment;
+            return;
+        }
+
+        const QString location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (!location.isEmpty())
+            directory = location + QStringLiteral("/qmlscreenextras-icons");
+    }
+
+    void dropStale(const ScreenMetrics &metrics);
+    void pruneDisk(const QString &fileName, qint64 written);
+
+    QMutex mutex;
+    QCache<QString, CachedIcon> icons;
+    // keys that a thread is rasterizing, the others wait for it
+    QSet<QString> inFlight;
+    QWaitCondition rasterized;
+    // the values the icons in memory were last checked against
+    double gridUnit;
+    double devicePixelRatio;
+    QString directory;
+
+    QMutex diskMutex;
+    // bytes in the directory, -1 until the first write
+    qint64 diskSize;
+};
+
+Q_GLOBAL_STATIC(IconCache, iconCache)
+
+// only the icons that now come to a different size go
+void IconCache::dropStale(const ScreenMetrics &metrics)
+{
+    if (metrics.gridUnit == gridUnit && metrics.devicePixelRatio == devicePixelRatio)
+        return;
+    gridUnit = metrics.gridUnit;
+    devicePixelRatio = metrics.devicePixelRatio;
+
+    foreach (const QString &key, icons.keys())
+    {
+        const CachedIcon *icon = icons.object(key);
+        if (icon && deviceBox(icon->size, icon->inGridUnits, metrics) != icon->box)
+            icons.remove(key);
+    }
+}
+
+/*
+  Called after every write. The files of older versions of the same source go
+  right away, and once the folder holds more than DiskCacheSize the oldest files
+  go until it is back at three quarters of that. That also takes care of the
+  sizes an earlier grid unit or device pixel ratio came to.
+*/
+void IconCache::pruneDisk(const QString &fileName, qint64 written)
+{
+    QMutexLocker locker(&diskMutex);
+
+    const QDir dir(directory);
+    const QString name = QFileInfo(fileName).fileName();
+    const QString source = name.section(QLatin1Char('-'), 0, 0);
+    const QString version = name.section(QLatin1Char('-'), 1, 1);
+
+    if (diskSize < 0)
+    {
+        diskSize = 0;
+        foreach (const QFileInfo &info, dir.entryInfoList(QStringList() << QStringLiteral("*.icon"), QDir::Files))
+            diskSize += info.size();
+    }
+    else
+    {
+        diskSize += written;
+    }
+
+    foreach (const QFileInfo &info, dir.entryInfoList(QStringList() << source + QStringLiteral("-*.icon"), QDir::Files))
+    {
+        if (info.fileName().section(QLatin1Char('-'), 1, 1) != version && QFile::remove(info.filePath()))
+            diskSize -= info.size();
+    }
+
+    const qint64 limit = qint64(DiskCacheSize) * 1024 * 1024;
+    if (diskSize <= limit)
+        return;
+
+    foreach (const QFileInfo &info, dir.entryInfoList(QStringList() << QStringLiteral("*.icon"), QDir::Files,
+                                                      QDir::Time | QDir::Reversed))
+    {
+        if (diskSize <= limit / 4 * 3)
+            break;
+        if (info.fileName() != name && QFile::remove(info.filePath()))
+            diskSize -= info.size();
+    }
+}
+
+void unmapIconFile(void *file)
+{
+    delete static_cast<QFile *>(file);
+}
+
+QString hashed(const QString &text)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+// <source>-<version>-<box>.icon, so that the files of an edited source can be found
+QString diskFileName(const QString &directory, const QString &path, const QSize &box)
+{
+    const QFileInfo info(path);
+    const QString version = QString::number(info.lastModified().toMSecsSinceEpoch()) + QLatin1Char('|')
+            + QString::number(info.size());
+
+    return directory + QLatin1Char('/') + hashed(path)
+            + QLatin1Char('-') + hashed(version).left(16)
+            + QLatin1Char('-') + QString::number(box.width()) + QLatin1Char('x') + QString::number(box.height())
+            + QStringLiteral(".icon");
+}
+
+// the pixels stay in the file, mapped copy on write until the image is gone
+QImage readIconFile(const QString &fileName)
+{
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(IconFileHeader)))
+    {
+        delete file;
+        return QImage();
+    }
+
+    // not read only, QImage would copy the pixels to set the device pixel ratio
+    uchar *data = file->map(0, file->size(), QFileDevice::MapPrivateOption);
+    const IconFileHeader *header = reinterpret_cast<const IconFileHeader *>(data);
+    if (!data
+            || header->magic != IconFileMagic
+            || header->version != IconFileVersion
+            || header->format != QImage::Format_ARGB32_Premultiplied
+            || file->size() < qint64(sizeof(IconFileHeader)) + qint64(header->bytesPerLine) * header->height)
+    {
+        delete file;
+        return QImage();
+    }
+
+    return QImage(data + sizeof(IconFileHeader), header->width, header->height, header->bytesPerLine,
+                  QImage::Format_ARGB32_Premultiplied, unmapIconFile, file);
+}
+
+bool writeIconFile(const QString &fileName, const QImage &image)
+{
+    IconFileHeader header;
+    header.magic = IconFileMagic;
+    header.version = IconFileVersion;
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = image.bytesPerLine();
+    header.format = image.format();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) < 0
+            || file.write(reinterpret_cast<const char *>(image.constBits()), qint64(image.bytesPerLine()) * image.height()) < 0
+            || !file.commit())
+    {
+        qCWarning(lcScreenExtras) << "QmlScreenExtras: can not write icon cache" << fileName;
+        return false;
+    }
+    return true;
+}
+
+// unlike photos, icons are scaled up as well
+QSize iconSize(const QSize &natural, const QSize &box)
+{
+    if (!natural.isValid() || natural.isEmpty())
+        return QSize(box.width() > 0 ? box.width() : box.height(), box.height() > 0 ? box.height() : box.width());
+    if (box.width() > 0 && box.height() > 0)
+        return natural.scaled(box, Qt::KeepAspectRatio);
+    if (box.width() > 0)
+        return QSize(box.width(), qMax(1, qRound(double(natural.height()) * box.width() / natural.width())));
+    return QSize(qMax(1, qRound(double(natural.width()) * box.height() / natural.height())), box.height());
+}
+
+// from the disk cache, or rasterized and written there
+QImage loadIcon(IconCache *cache, const QString &path, const QSize &box, QString *error)
+{
+    const QString fileName = cache->directory.isEmpty() ? QString() : diskFileName(cache->directory, path, box);
+
+    if (!fileName.isEmpty())
+    {
+        const QImage image = readIconFile(fileName);
+        if (!image.isNull())
+            return image;
+    }
+
+    QImageReader reader(path);
+    const QSize natural = reader.size();
+    if (box.width() > 0 || box.height() > 0)
+        reader.setScaledSize(iconSize(natural, box));
+
+    QImage image = reader.read();
+    if (image.isNull())
+    {
+        *error = QStringLiteral("QmlScreenExtras: can not rasterize ") + path + QStringLiteral(": ") + reader.errorString();
+        return QImage();
+    }
+
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (!fileName.isEmpty() && writeIconFile(fileName, image))
+        cache->pruneDisk(fileName, qint64(sizeof(IconFileHeader)) + qint64(image.bytesPerLine()) * image.height());
+    return image;
+}
+
+} // namespace
+
+/*!
+   \qmltype ScreenIconProvider
+   \inqmlmodule QmlScreenExtras
+   \brief Rasterizes vector icons once per size for every window and engine
+
+   Every Image with an SVG source rasterizes it again, for every instance and again
+   after the device pixel ratio changed. The screenicons image provider does it once for
+   each icon, size and device pixel ratio in the whole process, on the thread pool of the
+   screenextras provider
+
+     \code
+     Image {
+        source: "image://screenicons/3/qrc:/icons/menu.svg"
+     }
+     \endcode
+
+   The size is in grid units, "3" is 3 wide and as high as the aspect ratio makes it and
+   "3x4" fits into 3 by 4. Without a size the sourceSize of the Image is used. The icon
+   has as many pixels as the size has device pixels and carries the device pixel ratio,
+   so an Image without a width and height is as large as the size. SVG needs the svg
+   image format plugin. Icons that are asked for again while they are rasterized wait
+   for the first request instead of being rasterized twice.
+
+   The icons are kept in memory, up to 32 MB, and written to a disk cache. At the next
+   start they are mapped from there instead of being rasterized again. The cache is in
+   the cache location of the application unless QMLSCREENEXTRAS_ICON_CACHE names another
+   folder, or is "off". When the grid unit or the device pixel ratio changes only the
+   icons that come to a different size are dropped. Files of an icon that was edited
+   since are removed, and the disk cache is kept to 64 MB by removing the oldest files.
+*/
+
+ScreenIconProvider::ScreenIconProvider() :
+    QQuickAsyncImageProvider()
+{
+}
+
+QQuickImageResponse *ScreenIconProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    ScreenImageResponse *response = new ScreenImageResponse();
+
+    ScreenImageJob *job = new ScreenImageJob(&ScreenIconProvider::rasterize, id, requestedSize);
+    QObject::connect(job, &ScreenImageJob::decoded,
+                     response, &ScreenImageResponse::setImage, Qt::QueuedConnection);
+    ScreenImageProvider::threadPool()->start(job);
+
+    return response;
+}
+
+QString ScreenIconProvider::cacheDirectory()
+{
+    return iconCache()->directory;
+}
+
+QImage ScreenIconProvider::rasterize(const QString &id, const QSize &requestedSize, QString *error)
+{
+    QSizeF size;
+    const QString source = ScreenImageProvider::parseId(id, &size);
+    const bool inGridUnits = size.isValid();
+    if (!inGridUnits)
+        size = QSizeF(qMax(0, requestedSize.width()), qMax(0, requestedSize.height()));
+
+    const QString path = ScreenImageProvider::localPath(source);
+    if (path.isEmpty())
+    {
+        *error = QStringLiteral("QmlScreenExtras: only local and qrc icons can be loaded, not ") + source;
+        return QImage();
+    }
+
+    const std::shared_ptr<const ScreenMetrics> metrics = ScreenMetrics::current();
+    const QSize box = deviceBox(size, inGridUnits, *metrics);
+    const QString key = path + (inGridUnits ? QStringLiteral("|gu|") : QStringLiteral("|px|"))
+            + QString::number(size.width()) + QLatin1Char('x') + QString::number(size.height());
+
+    IconCache *cache = iconCache();
+    {
+        QMutexLocker locker(&cache->mutex);
+        // a list of the same icon asks for it many times at once
+        while (cache->inFlight.contains(key))
+            cache->rasterized.wait(&cache->mutex);
+
+        cache->dropStale(*metrics);
+        if (const CachedIcon *icon = cache->icons.object(key))
+        {
+            if (icon->box == box && icon->image.devicePixelRatio() == metrics->devicePixelRatio)
+                return icon->image;
+        }
+        cache->inFlight.insert(key);
+    }
+
+    QImage image = loadIcon(cache, path, box, error);
+    // an Image without a width and height is shown at the size that was asked for
+    if (!image.isNull())
+        image.setDevicePixelRatio(metrics->devicePixelRatio);
+
+    QMutexLocker locker(&cache->mutex);
+    cache->inFlight.remove(key);
+    cache->rasterized.wakeAll();
+
+    if (!image.isNull())
+    {
+        CachedIcon *icon = new CachedIcon;
+        icon->image = image;
+        icon->size = size;
+        icon->inGridUnits = inGridUnits;
+        icon->box = box;
+        cache->icons.insert(key, icon, qMax(1, image.bytesPerLine() * image.height() / 1024));
+    }
+    return image;
+}
@@ -0,0 +1,51 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENICONPROVIDER_H
+#define SCREENICONPROVIDER_H
+
+#include <QImage>
+#include <QQuickImageProvider>
+
+/*
+  image://screenicons/<size>/<source> rasterizes an SVG, or any other image,
+  once per size in grid units and device pixel ratio for the whole process
+
+    Image { source: "image://screenicons/3/qrc:/icons/menu.svg" }
+*/
+class ScreenIconProvider : public QQuickAsyncImageProvider
+{
+public:
+    ScreenIconProvider();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize);
+
+    // safe to call from any thread
+    static QImage rasterize(const QString &id, const QSize &requestedSize, QString *error);
+
+    // empty when the disk cache is turned off
+    static QString cacheDirectory();
+};
+
+#endif // SCREENICONPROVIDER_H
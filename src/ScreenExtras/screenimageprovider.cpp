@@ -0,0 +1,283 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screenimageprovider.h"
+#include "screenmetrics.h"
+#include "screentimings.h"
+#include <QCache>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QUrl>
+
+namespace {
+
+// MB, QMLSCREENEXTRAS_IMAGE_CACHE can change it
+enum { DefaultCacheSize = 64 };
+
+struct ImagePool
+{
+    ImagePool()
+    {
+        pool.setMaxThreadCount(QThread::idealThreadCount());
+    }
+
+    QThreadPool pool;
+};
+
+Q_GLOBAL_STATIC(ImagePool, imagePool)
+
+/*
+  The decoded images of every engine, least recently used ones go first once
+  the cache is full. QCache itself is not thread safe and the images are
+  decoded on several threads at once.
+*/
+struct ImageCache
+{
+    ImageCache() :
+        images(DefaultCacheSize * 1024)
+    {
+        bool ok = false;
+        const int megabytes = qEnvironmentVariableIntValue("QMLSCREENEXTRAS_IMAGE_CACHE", &ok);
+        if (ok && megabytes >= 0)
+            images.setMaxCost(megabytes * 1024);
+    }
+
+    QMutex mutex;
+    // cost in KB
+    QCache<QString, QImage> images;
+};
+
+Q_GLOBAL_STATIC(ImageCache, imageCache)
+
+// the largest size within the box that keeps the aspect ratio and is not larger than the image
+QSize fittedSize(const QSize &image, const QSize &box)
+{
+    if (!image.isValid() || image.isEmpty())
+        return box;
+
+    QSize fitted = image;
+    if (box.width() > 0 && box.height() > 0)
+        fitted = image.scaled(box, Qt::KeepAspectRatio);
+    else if (box.width() > 0)
+        fitted = QSize(box.width(), qRound(double(image.height()) * box.width() / image.width()));
+    else if (box.height() > 0)
+        fitted = QSize(qRound(double(image.width()) * box.height() / image.height()), box.height());
+
+    if (fitted.width() >= image.width() || fitted.height() >= image.height())
+        return image;
+    return fitted.expandedTo(QSize(1, 1));
+}
+
+} // namespace
+
+/*!
+   \qmltype ScreenImageProvider
+   \inqmlmodule QmlScreenExtras
+   \brief Decodes images at the size they are shown at
+
+   An image with a width of ScreenExtras.gu(12) is usually decoded at the full size of
+   the file, which for a photo is many times more pixels than are ever shown. The
+   screenextras image provider takes the size in grid units as part of the URL and
+   decodes the image straight to that many device pixels
+
+     \code
+     Image {
+        width: ScreenExtras.gu(12)
+        height: ScreenExtras.gu(8)
+        source: "image://screenextras/12x8/qrc:/photos/beach.jpg"
+     }
+     \endcode
+
+   The image keeps its aspect ratio within the box and is never made larger than the
+   file. Either size can be 0 to only fit the other one, "12x0" for example. Without any
+   size in the URL the sourceSize of the Image is used.
+
+   The images are decoded on a thread pool with a thread per core and kept in a cache
+   shared by all engines that holds 64 MB by default; set QMLSCREENEXTRAS_IMAGE_CACHE to
+   another size in MB. Only local files and qrc resources can be loaded.
+*/
+
+ScreenImageProvider::ScreenImageProvider() :
+    QQuickAsyncImageProvider()
+{
+}
+
+QQuickImageResponse *ScreenImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    ScreenImageResponse *response = new ScreenImageResponse();
+
+    ScreenImageJob *job = new ScreenImageJob(&ScreenImageProvider::decode, id, requestedSize);
+    QObject::connect(job, &ScreenImageJob::decoded,
+                     response, &ScreenImageResponse::setImage, Qt::QueuedConnection);
+    threadPool()->start(job);
+
+    return response;
+}
+
+QThreadPool *ScreenImageProvider::threadPool()
+{
+    return &imagePool()->pool;
+}
+
+QString ScreenImageProvider::parseId(const QString &id, QSizeF *units)
+{
+    // the size is optional, "12" is the same as "12x0"
+    *units = QSizeF();
+    const int slash = id.indexOf(QLatin1Char('/'));
+    if (slash <= 0)
+        return id;
+
+    const QStringList parts = id.left(slash).split(QLatin1Char('x'));
+    bool widthOk = false;
+    bool heightOk = parts.size() < 2;
+    const double width = parts.value(0).toDouble(&widthOk);
+    const double height = parts.size() < 2 ? 0.0 : parts.at(1).toDouble(&heightOk);
+    if (!widthOk || !heightOk || parts.size() > 2)
+        return id;
+
+    *units = QSizeF(width, height);
+    return id.mid(slash + 1);
+}
+
+QString ScreenImageProvider::localPath(const QString &source)
+{
+    const QUrl url(source);
+    if (url.scheme() == QLatin1String("qrc"))
+        return QLatin1Char(':') + url.path();
+    if (url.isLocalFile())
+        return url.toLocalFile();
+    if (url.scheme().isEmpty() || QFileInfo(source).isAbsolute())
+        return source;
+    return QString();
+}
+
+QImage ScreenImageProvider::decode(const QString &id, const QSize &requestedSize, QString *error)
+{
+    QSizeF units;
+    const QString source = parseId(id, &units);
+
+    const QString path = localPath(source);
+    if (path.isEmpty())
+    {
+        *error = QStringLiteral("QmlScreenExtras: only local and qrc images can be loaded, not ") + source;
+        return QImage();
+    }
+
+    // in device pixels
+    const std::shared_ptr<const ScreenMetrics> metrics = ScreenMetrics::current();
+    const double devicePixelRatio = metrics->devicePixelRatio;
+    QSize box;
+    if (units.isValid())
+    {
+        box = QSize(qRound(units.width() * metrics->gridUnit * devicePixelRatio),
+                    qRound(units.height() * metrics->gridUnit * devicePixelRatio));
+    }
+    else if (requestedSize.width() > 0 || requestedSize.height() > 0)
+    {
+        box = QSize(qMax(0, qRound(requestedSize.width() * devicePixelRatio)),
+                    qMax(0, qRound(requestedSize.height() * devicePixelRatio)));
+    }
+
+    const QString key = path + QLatin1Char('|')
+            + QString::number(box.width()) + QLatin1Char('x') + QString::number(box.height())
+            + QLatin1Char('|') + QString::number(devicePixelRatio);
+
+    ImageCache *cache = imageCache();
+    {
+        QMutexLocker locker(&cache->mutex);
+        if (QImage *cached = cache->images.object(key))
+            return *cached;
+    }
+
+    QImageReader reader(path);
+    const QSize original = reader.size();
+    const QSize target = fittedSize(original, box);
+
+    // decoders like JPEG only decode the pixels they need then
+    if (original.isValid() && target != original)
+        reader.setScaledSize(target);
+
+    QImage image = reader.read();
+    if (image.isNull())
+    {
+        *error = QStringLiteral("QmlScreenExtras: can not decode ") + path + QStringLiteral(": ") + reader.errorString();
+        return QImage();
+    }
+
+    // formats that do not know their size up front
+    if (!original.isValid())
+    {
+        const QSize fitted = fittedSize(image.size(), box);
+        if (fitted != image.size())
+            image = image.scaled(fitted, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    {
+        QMutexLocker locker(&cache->mutex);
+        cache->images.insert(key, new QImage(image), qMax(1, image.bytesPerLine() * image.height() / 1024));
+    }
+    return image;
+}
+
+ScreenImageResponse::ScreenImageResponse() :
+    QQuickImageResponse()
+{
+}
+
+QQuickTextureFactory *ScreenImageResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString ScreenImageResponse::errorString() const
+{
+    return m_error;
+}
+
+void ScreenImageResponse::setImage(const QImage &image, const QString &error)
+{
+    m_image = image;
+    m_error = error;
+    emit finished();
+}
+
+ScreenImageJob::ScreenImageJob(Decoder decoder, const QString &id, const QSize &requestedSize) :
+    QObject(),
+    QRunnable(),
+    m_decoder(decoder),
+    m_id(id),
+    m_requestedSize(requestedSize)
+{
+}
+
+void ScreenImageJob::run()
+{
+    QString error;
+    const QImage image = m_decoder(m_id, m_requestedSize, &error);
+    emit decoded(image, error);
+}
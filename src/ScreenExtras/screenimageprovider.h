@@ -0,0 +1,99 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENIMAGEPROVIDER_H
+#define SCREENIMAGEPROVIDER_H
+
+#include <QImage>
+#include <QQuickImageProvider>
+#include <QRunnable>
+
+class QThreadPool;
+
+/*
+  image://screenextras/<width>x<height>/<source> decodes a local or qrc
+  image at the size it is shown at. Width and height are in grid units and
+  either one can be 0 to follow the aspect ratio of the image
+
+    Image { source: "image://screenextras/12x0/qrc:/photos/beach.jpg" }
+*/
+class ScreenImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    ScreenImageProvider();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize);
+
+    // one per process, as many threads as there are cores
+    static QThreadPool *threadPool();
+
+    // the decoding itself, safe to call from any thread
+    static QImage decode(const QString &id, const QSize &requestedSize, QString *error);
+
+    // splits "12x8/qrc:/photo.jpg" into the size in grid units and the source
+    static QString parseId(const QString &id, QSizeF *units);
+    // a path QImageReader can open, empty for remote urls
+    static QString localPath(const QString &source);
+};
+
+class ScreenImageResponse : public QQuickImageResponse
+{
+    Q_OBJECT
+
+public:
+    ScreenImageResponse();
+
+    QQuickTextureFactory *textureFactory() const;
+    QString errorString() const;
+
+public slots:
+    void setImage(const QImage &image, const QString &error);
+
+private:
+    QImage m_image;
+    QString m_error;
+};
+
+// Decodes on the thread pool and hands the image to the response
+class ScreenImageJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    typedef QImage (*Decoder)(const QString &id, const QSize &requestedSize, QString *error);
+
+    ScreenImageJob(Decoder decoder, const QString &id, const QSize &requestedSize);
+
+    void run();
+
+signals:
+    void decoded(const QImage &image, const QString &error);
+
+private:
+    Decoder m_decoder;
+    QString m_id;
+    QSize m_requestedSize;
+};
+
+#endif // SCREENIMAGEPROVIDER_H
@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screenmetrics.h"
+#include <QVector>
+#include <atomic>
+
+namespace
+{
+
+/*
+  std::atomic_load() on a shared_ptr takes a lock from a global pool in
+  libstdc++ and libc++, so the copy is published through a plain atomic
+  pointer instead. A reader only copies the shared_ptr it points to while
+  it is counted in readers, and the GUI thread only deletes a replaced one
+  once it saw no reader at all after the swap. Any reader that starts after
+  that already loads the new pointer.
+*/
+struct Published
+{
+    Published() :
+        current(new std::shared_ptr<const ScreenMetrics>(std::make_shared<const ScreenMetrics>())),
+        readers(0)
+    {
+    }
+
+    std::atomic<const std::shared_ptr<const ScreenMetrics> *> current;
+    std::atomic<int> readers;
+    // replaced copies still waiting for the readers to be gone, GUI thread only
+    QVector<const std::shared_ptr<const ScreenMetrics> *> retired;
+};
+
+Published &published()
+{
+    static Published metrics;
+    return metrics;
+}
+
+} // namespace
+
+std::shared_ptr<const ScreenMetrics> ScreenMetrics::current()
+{
+    Published &state = published();
+    state.readers.fetch_add(1);
+    std::shared_ptr<const ScreenMetrics> metrics = *state.current.load();
+    state.readers.fetch_sub(1);
+    return metrics;
+}
+
+void ScreenMetrics::publish(const ScreenMetrics &metrics)
+{
+    Published &state = published();
+    state.retired.append(state.current.exchange(
+            new std::shared_ptr<const ScreenMetrics>(std::make_shared<const ScreenMetrics>(metrics))));
+
+    if (state.readers.load() != 0)
+        return;
+    foreach (const std::shared_ptr<const ScreenMetrics> *previous, state.retired)
+        delete previous;
+    state.retired.clear();
+}
@@ -0,0 +1,122 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENMETRICS_H
+#define SCREENMETRICS_H
+
+#include <QObject>
+#include <QMetaType>
+#include <QString>
+#include <memory>
+
+// One entry for every ScreenExtras::Font, NOTSET included
+enum { ScreenMetricsFontCount = 8 };
+
+/*
+  One copy of everything ScreenExtras works out, taken after each update.
+
+  The latest copy is also published for other threads. current() can be
+  called from the render thread or a worker without any locking, the copy
+  it hands out never changes and stays valid for as long as it is held.
+  In lazy mode a value is only in there once the GUI thread read it.
+*/
+class ScreenMetrics
+{
+    Q_GADGET
+
+    Q_PROPERTY( int generation MEMBER generation )
+    Q_PROPERTY( int desktopWidth MEMBER desktopWidth )
+    Q_PROPERTY( int desktopHeight MEMBER desktopHeight )
+    Q_PROPERTY( int virtualWidth MEMBER virtualWidth )
+    Q_PROPERTY( int virtualHeight MEMBER virtualHeight )
+    Q_PROPERTY( int numberOfScreens MEMBER numberOfScreens )
+    Q_PROPERTY( double displaySize MEMBER displaySize )
+    Q_PROPERTY( double devicePixelRatio MEMBER devicePixelRatio )
+    Q_PROPERTY( double gridUnit MEMBER gridUnit )
+    Q_PROPERTY( double exactGridUnit MEMBER exactGridUnit )
+    Q_PROPERTY( double scaleSize MEMBER scaleSize )
+    Q_PROPERTY( QString primaryScreenName MEMBER primaryScreenName )
+    Q_PROPERTY( QString formFactor MEMBER formFactor )
+    Q_PROPERTY( double physicalDotsPerInch MEMBER physicalDotsPerInch )
+    Q_PROPERTY( double logicalDotsPerInch MEMBER logicalDotsPerInch )
+
+public:
+    ScreenMetrics() :
+        generation(0),
+        desktopWidth(0),
+        desktopHeight(0),
+        virtualWidth(0),
+        virtualHeight(0),
+        numberOfScreens(0),
+        displaySize(0.0),
+        devicePixelRatio(1.0),
+        gridUnit(8),
+        exactGridUnit(8),
+        scaleSize(1.0),
+        physicalDotsPerInch(96.0),
+        logicalDotsPerInch(96.0)
+    {
+        for (int i = 0; i < ScreenMetricsFontCount; ++i)
+            fontSizes[i] = 0.0;
+    }
+
+    Q_INVOKABLE double font(int font) const
+    {
+        return font >= 0 && font < ScreenMetricsFontCount ? fontSizes[font] : 0.0;
+    }
+
+    // never null, before the first update it holds the defaults
+    static std::shared_ptr<const ScreenMetrics> current();
+    // only called by ScreenExtrasCore on the GUI thread
+    static void publish(const ScreenMetrics &metrics);
+
+    int generation;
+
+    int desktopWidth;
+    int desktopHeight;
+    int virtualWidth;
+    int virtualHeight;
+    int numberOfScreens;
+
+    double displaySize;
+    double devicePixelRatio;
+    // snapped to device pixels when ScreenExtras.pixelSnapping is on
+    double gridUnit;
+    double exactGridUnit;
+    double scaleSize;
+
+    QString primaryScreenName;
+    QString formFactor;
+
+    // of the primary screen, in device independent pixels
+    double physicalDotsPerInch;
+    double logicalDotsPerInch;
+
+    // pixel sizes indexed by ScreenExtras::Font
+    double fontSizes[ScreenMetricsFontCount];
+};
+
+Q_DECLARE_METATYPE(ScreenMetrics)
+
+#endif // SCREENMETRICS_H
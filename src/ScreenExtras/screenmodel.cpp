@@ -0,0 +1,352 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screenmodel.h"
+#include "screenprofile.h"
+#include "screentimings.h"
+#include <QGuiApplication>
+#include <QScreen>
+
+/*!
+   \qmltype ScreenModel
+   \inqmlmodule QmlScreenExtras
+   \brief A list model with one row for every screen, see ScreenExtras::screens
+
+   The values are read from QScreen once and kept until that screen reports a
+   change, so delegates do not go back to the windowing system every time a binding
+   is evaluated. When a screen changes only its own row is updated.
+
+   The roles are
+
+   \list
+   \li name
+   \li geometry
+   \li availableGeometry
+   \li devicePixelRatio
+   \li logicalDotsPerInch
+   \li physicalDotsPerInch
+   \li diagonal
+   \li refreshRate
+   \li formFactor
+   \li gridUnit
+   \li primary
+   \endlist
+
+   Example:
+
+   \code
+   Repeater {
+       model: ScreenExtras.screens
+       Text {
+           text: qsTr("%1 %2Hz %3").arg(model.name).arg(model.refreshRate).arg(model.formFactor)
+       }
+   }
+   \endcode
+*/
+
+ScreenModel::Entry::Entry() :
+    dirty(false),
+    devicePixelRatio(1.0),
+    logicalDotsPerInch(0.0),
+    physicalDotsPerInch(0.0),
+    diagonal(0.0),
+    refreshRate(0.0),
+    formFactor("desktop"),
+    gridUnit(ScreenProfile::DefaultGridUnit),
+    primary(false)
+{
+}
+
+ScreenModel::ScreenModel(QObject *parent) :
+    QAbstractListModel(parent)
+{
+    ScreenTimingScope timing(ScreenTimings::ScreenList);
+
+    // several signals usually come in for one change of a screen
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, &QTimer::timeout,
+            this, &ScreenModel::updateChangedScreens);
+
+    connect(qGuiApp, &QGuiApplication::screenAdded,
+            this, &ScreenModel::onScreenAdded);
+    connect(qGuiApp, &QGuiApplication::screenRemoved,
+            this, &ScreenModel::onScreenRemoved);
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
+            this, &ScreenModel::onPrimaryScreenChanged);
+
+    foreach (QScreen *screen, QGuiApplication::screens())
+    {
+        Entry entry;
+        entry.screen = screen;
+        readScreen(entry);
+        m_entries.append(entry);
+        watchScreen(screen);
+    }
+}
+
+int ScreenModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_entries.size();
+}
+
+QVariant ScreenModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const Entry &entry = m_entries.at(index.row());
+    switch (role)
+    {
+    case NameRole:
+        return entry.name;
+    case GeometryRole:
+        return entry.geometry;
+    case AvailableGeometryRole:
+        return entry.availableGeometry;
+    case DevicePixelRatioRole:
+        return entry.devicePixelRatio;
+    case LogicalDotsPerInchRole:
+        return entry.logicalDotsPerInch;
+    case PhysicalDotsPerInchRole:
+        return entry.physicalDotsPerInch;
+    case DiagonalRole:
+        return entry.diagonal;
+    case RefreshRateRole:
+        return entry.refreshRate;
+    case FormFactorRole:
+        return entry.formFactor;
+    case GridUnitRole:
+        return entry.gridUnit;
+    case PrimaryRole:
+        return entry.primary;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ScreenModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[GeometryRole] = "geometry";
+    roles[AvailableGeometryRole] = "availableGeometry";
+    roles[DevicePixelRatioRole] = "devicePixelRatio";
+    roles[LogicalDotsPerInchRole] = "logicalDotsPerInch";
+    roles[PhysicalDotsPerInchRole] = "physicalDotsPerInch";
+    roles[DiagonalRole] = "diagonal";
+    roles[RefreshRateRole] = "refreshRate";
+    roles[FormFactorRole] = "formFactor";
+    roles[GridUnitRole] = "gridUnit";
+    roles[PrimaryRole] = "primary";
+    return roles;
+}
+
+/*!
+ \qmlproperty int ScreenModel::count
+    The number of screens in the model
+ */
+int ScreenModel::count() const
+{
+    return m_entries.size();
+}
+
+QString ScreenModel::nameAt(int row) const
+{
+    if (row < 0 || row >= m_entries.size())
+        return QString();
+    return m_entries.at(row).name;
+}
+
+qreal ScreenModel::refreshRateAt(int row) const
+{
+    if (row < 0 || row >= m_entries.size())
+        return 0.0;
+    return m_entries.at(row).refreshRate;
+}
+
+double ScreenModel::gridUnitAt(int row) const
+{
+    if (row < 0 || row >= m_entries.size())
+        return ScreenProfile::DefaultGridUnit;
+    return m_entries.at(row).gridUnit;
+}
+
+QString ScreenModel::formFactorAt(int row) const
+{
+    if (row < 0 || row >= m_entries.size())
+        return QString();
+    return m_entries.at(row).formFactor;
+}
+
+int ScreenModel::indexOf(QScreen *screen) const
+{
+    for (int i = 0; i < m_entries.size(); ++i)
+    {
+        if (m_entries.at(i).screen == screen)
+            return i;
+    }
+    return -1;
+}
+
+void ScreenModel::watchScreen(QScreen *screen)
+{
+    connect(screen, &QScreen::geometryChanged,
+            this, &ScreenModel::onScreenChanged);
+    connect(screen, &QScreen::availableGeometryChanged,
+            this, &ScreenModel::onScreenChanged);
+    connect(screen, &QScreen::physicalSizeChanged,
+            this, &ScreenModel::onScreenChanged);
+    connect(screen, &QScreen::logicalDotsPerInchChanged,
+            this, &ScreenModel::onScreenChanged);
+    connect(screen, &QScreen::physicalDotsPerInchChanged,
+            this, &ScreenModel::onScreenChanged);
+    connect(screen, &QScreen::refreshRateChanged,
+            this, &ScreenModel::onScreenChanged);
+}
+
+void ScreenModel::readScreen(Entry &entry)
+{
+    QScreen *screen = entry.screen;
+    if (!screen)
+        return;
+
+    const ScreenProfile profile = ScreenProfile::forScreen(screen);
+
+    entry.name = screen->name();
+    entry.geometry = screen->geometry();
+    entry.availableGeometry = screen->availableGeometry();
+    entry.devicePixelRatio = screen->devicePixelRatio();
+    entry.logicalDotsPerInch = screen->logicalDotsPerInch();
+    entry.physicalDotsPerInch = screen->physicalDotsPerInch();
+    entry.diagonal = profile.diagonal;
+    entry.refreshRate = screen->refreshRate();
+    entry.formFactor = profile.formFactor;
+    entry.gridUnit = profile.gridUnit();
+    entry.primary = (screen == QGuiApplication::primaryScreen());
+}
+
+QVector<int> ScreenModel::changedRoles(const Entry &before, const Entry &after)
+{
+    QVector<int> roles;
+    if (before.name != after.name)
+        roles << NameRole;
+    if (before.geometry != after.geometry)
+        roles << GeometryRole;
+    if (before.availableGeometry != after.availableGeometry)
+        roles << AvailableGeometryRole;
+    if (before.devicePixelRatio != after.devicePixelRatio)
+        roles << DevicePixelRatioRole;
+    if (before.logicalDotsPerInch != after.logicalDotsPerInch)
+        roles << LogicalDotsPerInchRole;
+    if (before.physicalDotsPerInch != after.physicalDotsPerInch)
+        roles << PhysicalDotsPerInchRole;
+    if (before.diagonal != after.diagonal)
+        roles << DiagonalRole;
+    if (before.refreshRate != after.refreshRate)
+        roles << RefreshRateRole;
+    if (before.formFactor != after.formFactor)
+        roles << FormFactorRole;
+    if (before.gridUnit != after.gridUnit)
+        roles << GridUnitRole;
+    if (before.primary != after.primary)
+        roles << PrimaryRole;
+    return roles;
+}
+
+void ScreenModel::onScreenAdded(QScreen *screen)
+{
+    if (indexOf(screen) != -1)
+        return;
+
+    Entry entry;
+    entry.screen = screen;
+    readScreen(entry);
+
+    const int row = m_entries.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_entries.append(entry);
+    endInsertRows();
+
+    watchScreen(screen);
+    emit countChanged();
+}
+
+void ScreenModel::onScreenRemoved(QScreen *screen)
+{
+    const int row = indexOf(screen);
+    if (row == -1)
+        return;
+
+    disconnect(screen, 0, this, 0);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_entries.remove(row);
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+void ScreenModel::onPrimaryScreenChanged(QScreen *screen)
+{
+    Q_UNUSED(screen)
+    // the old and the new primary screen both change their primary role
+    for (int i = 0; i < m_entries.size(); ++i)
+        m_entries[i].dirty = true;
+    m_updateTimer.start();
+}
+
+void ScreenModel::onScreenChanged()
+{
+    const int row = indexOf(qobject_cast<QScreen *>(sender()));
+    if (row == -1)
+        return;
+
+    m_entries[row].dirty = true;
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+void ScreenModel::updateChangedScreens()
+{
+    for (int row = 0; row < m_entries.size(); ++row)
+    {
+        Entry &entry = m_entries[row];
+        if (!entry.dirty)
+            continue;
+        entry.dirty = false;
+
+        const Entry before = entry;
+        readScreen(entry);
+
+        const QVector<int> roles = changedRoles(before, entry);
+        if (!roles.isEmpty())
+        {
+            const QModelIndex changed = index(row);
+            emit dataChanged(changed, changed, roles);
+        }
+    }
+}
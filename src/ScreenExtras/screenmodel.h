@@ -0,0 +1,111 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENMODEL_H
+#define SCREENMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QRect>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class QScreen;
+
+class ScreenModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY( int count READ count NOTIFY countChanged )
+
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        GeometryRole,
+        AvailableGeometryRole,
+        DevicePixelRatioRole,
+        LogicalDotsPerInchRole,
+        PhysicalDotsPerInchRole,
+        DiagonalRole,
+        RefreshRateRole,
+        FormFactorRole,
+        GridUnitRole,
+        PrimaryRole
+    };
+
+    explicit ScreenModel( QObject *parent = 0 );
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    int count() const;
+
+    QString nameAt(int row) const;
+    qreal refreshRateAt(int row) const;
+    double gridUnitAt(int row) const;
+    QString formFactorAt(int row) const;
+    int indexOf(QScreen *screen) const;
+
+signals:
+    void countChanged();
+
+protected slots:
+    void onScreenAdded(QScreen *screen);
+    void onScreenRemoved(QScreen *screen);
+    void onPrimaryScreenChanged(QScreen *screen);
+    void onScreenChanged();
+    void updateChangedScreens();
+
+private:
+    struct Entry
+    {
+        Entry();
+
+        QPointer<QScreen> screen;
+        bool dirty;
+
+        QString name;
+        QRect geometry;
+        QRect availableGeometry;
+        double devicePixelRatio;
+        double logicalDotsPerInch;
+        double physicalDotsPerInch;
+        double diagonal;
+        qreal refreshRate;
+        QString formFactor;
+        double gridUnit;
+        bool primary;
+    };
+
+    void watchScreen(QScreen *screen);
+    static void readScreen(Entry &entry);
+    static QVector<int> changedRoles(const Entry &before, const Entry &after);
+
+    QVector<Entry> m_entries;
+    QTimer m_updateTimer;
+};
+
+#endif // SCREENMODEL_H
@@ -0,0 +1,292 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "screenprofile.h"
+#include "formfactor.h"
+#include "profilecache.h"
+#include "screenfonts.h"
+#include "screentimings.h"
+#include <qmath.h>
+#include <QScreen>
+#include <QSysInfo>
+
+ScreenProfile::ScreenProfile() :
+    isValid(false),
+    os(FormFactorRules::UnknownOs),
+    type(FormFactorRules::Desktop),
+    formFactor("desktop"),
+    scaleSize(1.0),
+    diagonal(0.0)
+{
+}
+
+double ScreenProfile::gridUnit() const
+{
+    return scaleSize * DefaultGridUnit;
+}
+
+bool ScreenProfile::hasFontSizes() const
+{
+    return fontSizes.size() == FontTable::FontCount;
+}
+
+static double checkIphoneScaleSize(
+        const int &width,
+        const int &height,
+        const double &iPhoneVersion )
+{
+    if( iPhoneVersion >= 4 )
+    {
+        if (width >= 320 && width < 321&& height < 567 ){
+            return 1.0;
+        }
+        else if (height >  567 && height < 569 && width  == 320){
+            return 1.0;
+        }
+        else if (height >  665  && height < 668 && width  == 375)
+        {
+            return 1.0;
+        }
+        else if (width >= 374  && height  >= 665 )
+        {
+            return 1.0;
+        }
+    }
+    else
+    {
+        return 1.0;
+    }
+    return 1.0;
+}
+
+static ScreenProfile finalProfile(
+        const FormFactorRules::OperatingSystem os,
+        const double &versionORscaleSize,
+        const double diagonal )
+{
+    ScreenProfile profile;
+    profile.isValid = true;
+    profile.os = os;
+    profile.systemType = FormFactorRules::systemTypeName(os);
+    profile.diagonal = diagonal;
+    profile.type = FormFactorRules::classify(os, diagonal);
+    profile.formFactor = FormFactorRules::typeName(profile.type);
+    profile.scaleSize = versionORscaleSize;
+    return profile;
+}
+
+// IOS - now what version?
+static double iosVersion()
+{
+    switch (QSysInfo::MacintoshVersion)
+    {
+    case QSysInfo::MV_IOS_4_3: return 4.3;
+    case QSysInfo::MV_IOS_5_0: return 5.0;
+    case QSysInfo::MV_IOS_5_1: return 5.1;
+    case QSysInfo::MV_IOS_6_0: return 6.0;
+    case QSysInfo::MV_IOS_6_1: return 6.1;
+    case QSysInfo::MV_IOS_7_0: return 7.0;
+    case QSysInfo::MV_IOS_7_1: return 7.1;
+    case QSysInfo::MV_IOS_8_0: return 8.0;
+    case QSysInfo::MV_IOS_8_1: return 8.1;
+    case QSysInfo::MV_IOS_8_2: return 8.2;
+    case QSysInfo::MV_IOS_8_3: return 8.3;
+    case QSysInfo::MV_IOS_8_4: return 8.4;
+    case QSysInfo::MV_IOS_9_0: return 9.0;
+    default: return 6.0;
+    }
+}
+
+// Check the BuildArch to see if arm or arm 64.
+// Also look at x86_64 android
+static bool isArmBuild()
+{
+    const QString arch = QSysInfo::buildCpuArchitecture();
+    return arch == QLatin1String("arm") || arch == QLatin1String("arm64");
+}
+
+/*
+  Looks \a screen up in the profile cache and only runs detect() when it is
+  not in there yet or something about the screen changed since.
+*/
+ScreenProfile ScreenProfile::forScreen(QScreen *screen)
+{
+    if (!screen)
+        return ScreenProfile();
+
+    ScreenTimingScope timing(ScreenTimings::FormFactor);
+
+    if (ProfileCache::fileName().isEmpty())
+        return detect(screen);
+
+    const QString key = ProfileCache::key(screen);
+    ScreenProfile profile;
+    if (ProfileCache::lookup(key, &profile))
+        return profile;
+
+    profile = detect(screen);
+    if (profile.isValid)
+        ProfileCache::store(key, profile);
+    return profile;
+}
+
+/*
+  Works out the form factor and the scale for \a screen. This does not
+  touch any state so it can be used for any screen, not only the primary one.
+*/
+ScreenProfile ScreenProfile::detect(QScreen *screen)
+{
+    if (!screen)
+        return ScreenProfile();
+
+    double m_169 = qSqrt(
+                pow((screen->physicalSize().width()), 2) +
+                qPow((screen->physicalSize().height()), 2)) * 0.039370;
+
+    switch (FormFactorRules::currentOs())
+    {
+    case FormFactorRules::Ios:
+    {
+        static const double version = iosVersion();
+        return finalProfile( FormFactorRules::Ios,
+                             checkIphoneScaleSize(
+                                 screen->size().width(),
+                                 screen->size().height(),
+                                 version),
+                             m_169 );
+    }
+
+    case FormFactorRules::Android:
+    {
+        static const bool armBuild = isArmBuild();
+        if (!armBuild)
+        {
+            qCDebug(lcScreenExtras) << "we know that it is android but we do not know the DPI so we have to make another work around";
+            return ScreenProfile();
+        }
+
+        // SOURCE:
+        // https://developer.android.com/guide/practices/screens_support.html
+        const qreal dpi = screen->logicalDotsPerInch();
+        QString androidDpi;
+        double androidScale = 1.0;
+
+        //(low) 120dpi
+        if (dpi <= 120)
+        {
+            androidDpi = "ldpi";
+            androidScale = 1.0;
+        }
+        else if (dpi <= 160)
+        {
+            androidDpi = "mdpi";
+            androidScale = 1.5;
+        }
+        //(high) ~240dpi
+        else if (dpi <= 240)
+        {
+            androidDpi = "hdpi";
+            androidScale = 2.0;
+        }
+        else if (dpi <= 320)
+        {
+            androidDpi = "xhdpi" ;
+            androidScale = 3.0;
+        }
+        // (extra-high) ~320dpi
+        else if (dpi <= 480)
+        {
+            androidDpi = "xxhdpi" ;
+            androidScale  = 4.0;
+        }
+        // (extra-extra-high) ~480dpi and up
+        else
+        {
+            androidDpi = "xxxhdpi";
+            androidScale = 5.0;
+        }
+
+        ScreenProfile profile = finalProfile( FormFactorRules::Android, androidScale, m_169 );
+        profile.androidDpi = androidDpi;
+        return profile;
+    }
+
+    case FormFactorRules::WinPhone:
+        // FIXME
+        return ScreenProfile();
+
+    // WINDOWS LOOK FOR DPI
+    case FormFactorRules::Windows:
+    {
+        const qreal dpi = screen->logicalDotsPerInch();
+        const QSize size = screen->size();
+        double windowsDesktopScale = 1.0;
+
+        // SOURCE
+        // https://msdn.microsoft.com/en-us/library/windows/desktop/dn469266(v=vs.85).aspx
+        if (m_169 <= 10.5){
+            qCDebug(lcScreenExtras) << "This is small to small !";
+        }
+        else if (m_169 >=  10.6 && m_169 <=  11.5){
+            if (size.width() >= 1920 && size.height() >= 1080){
+                windowsDesktopScale = 1.5;
+            }
+        }
+        else if (m_169 >=  11.6 && m_169 <= 13.2){
+            if (size.width() >= 1920 && size.height() >= 1200){
+                windowsDesktopScale = 1.5;
+            }
+        }
+        else if (m_169 >=  13.3 && m_169 <= 15.3){
+            if(dpi >= 192) {
+                windowsDesktopScale = 2.0;
+            }
+        }
+        else if (m_169 >=  15.4 && m_169 <= 16.9){
+            if ( dpi >= 120 && dpi < 192){
+                windowsDesktopScale = 1.25;
+            }
+            else if (dpi >= 192  )
+            {
+                windowsDesktopScale = 2.0;
+            }
+        }
+        else if (m_169 >=  23 && m_169 < 24){
+            if (dpi >= 192){
+                windowsDesktopScale = 2.0;
+            }
+        }
+        return finalProfile (FormFactorRules::Windows, windowsDesktopScale, m_169);
+    }
+
+    case FormFactorRules::MacOs:
+        return finalProfile (FormFactorRules::MacOs, 1 , m_169);
+
+    case FormFactorRules::Linux:
+        return finalProfile (FormFactorRules::Linux, 1 , m_169);
+
+    default:
+        return ScreenProfile();
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENPROFILE_H
+#define SCREENPROFILE_H
+
+#include <QString>
+#include <QVector>
+
+#include "formfactor.h"
+
+class QScreen;
+
+// What the form factor detection works out for one screen
+struct ScreenProfile
+{
+    enum { DefaultGridUnit = 8 };
+
+    ScreenProfile();
+
+    double gridUnit() const;
+    bool hasFontSizes() const;
+
+    // false when the platform could not be worked out, the values are the defaults then
+    bool isValid;
+
+    FormFactorRules::OperatingSystem os;
+    QString systemType;
+    FormFactorRules::Type type;
+    QString formFactor;
+    QString androidDpi;
+
+    double scaleSize;
+    double diagonal;
+
+    // pixel sizes for every ScreenExtras::Font when they came from the
+    // profile cache, empty means they come from the font table
+    QVector<double> fontSizes;
+
+    // detect() with the result kept in the profile cache
+    static ScreenProfile forScreen(QScreen *screen);
+    static ScreenProfile detect(QScreen *screen);
+};
+
+#endif // SCREENPROFILE_H
@@ -0,0 +1,121 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+// the probes are made in this file only
+#ifdef QMLSCREENEXTRAS_TRACING
+#  define TRACEPOINT_CREATE_PROBES
+#  define TRACEPOINT_DEFINE
+#  include "qmlscreenextras_tracepoints_p.h"
+#endif
+
+#include "screentimings.h"
+#include <QMutex>
+
+Q_LOGGING_CATEGORY(lcScreenExtras, "qmlscreenextras")
+Q_LOGGING_CATEGORY(lcScreenExtrasTiming, "qmlscreenextras.timing", QtWarningMsg)
+
+namespace ScreenTimings
+{
+
+namespace
+{
+
+const char *const phaseNames[PhaseCount] =
+{
+    "pluginLoad",
+    "construction",
+    "screens",
+    "systemInfo",
+    "formFactor",
+    "fonts",
+    "screenModel",
+    "deviceProbe"
+};
+
+struct Recorded
+{
+    Recorded()
+    {
+        for (int i = 0; i < PhaseCount; ++i)
+            nsecs[i] = -1;
+    }
+
+    QMutex mutex;
+    qint64 nsecs[PhaseCount];
+};
+
+Q_GLOBAL_STATIC(Recorded, recorded)
+
+} // namespace
+
+bool isEnabled()
+{
+    static const bool enabled = lcScreenExtrasTiming().isDebugEnabled()
+            || qEnvironmentVariableIsSet("QMLSCREENEXTRAS_TIMINGS");
+    return enabled;
+}
+
+void record(Phase phase, qint64 nsecs)
+{
+    Recorded *times = recorded();
+    {
+        QMutexLocker locker(&times->mutex);
+        times->nsecs[phase] = nsecs;
+    }
+    qCDebug(lcScreenExtrasTiming, "%s took %.3f ms", phaseNames[phase], nsecs / 1000000.0);
+}
+
+QVariantMap toVariantMap()
+{
+    QVariantMap map;
+    if (!isEnabled())
+        return map;
+
+    Recorded *times = recorded();
+    QMutexLocker locker(&times->mutex);
+    for (int i = 0; i < PhaseCount; ++i)
+    {
+        if (times->nsecs[i] >= 0)
+            map.insert(QLatin1String(phaseNames[i]), times->nsecs[i] / 1000000.0);
+    }
+    return map;
+}
+
+} // namespace ScreenTimings
+
+ScreenTimingScope::ScreenTimingScope(ScreenTimings::Phase phase) :
+    m_phase(phase),
+    m_enabled(ScreenTimings::isEnabled())
+{
+    SCREENEXTRAS_TRACE(qmlscreenextras_phase_entry, int(m_phase));
+    if (m_enabled)
+        m_timer.start();
+}
+
+ScreenTimingScope::~ScreenTimingScope()
+{
+    SCREENEXTRAS_TRACE(qmlscreenextras_phase_exit, int(m_phase));
+    if (m_enabled)
+        ScreenTimings::record(m_phase, m_timer.nsecsElapsed());
+}
@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef SCREENTIMINGS_H
+#define SCREENTIMINGS_H
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QVariantMap>
+
+Q_DECLARE_LOGGING_CATEGORY(lcScreenExtras)
+Q_DECLARE_LOGGING_CATEGORY(lcScreenExtrasTiming)
+
+#ifdef QMLSCREENEXTRAS_TRACING
+#  include "qmlscreenextras_tracepoints_p.h"
+#  define SCREENEXTRAS_TRACE(...) Q_TRACE(__VA_ARGS__)
+#else
+#  define SCREENEXTRAS_TRACE(...) do { } while (0)
+#endif
+
+/*
+  How long each part of getting ScreenExtras ready took.
+
+  Timing is off unless the qmlscreenextras.timing logging category has debug
+  output turned on or QMLSCREENEXTRAS_TIMINGS is set. Builds made with
+  CONFIG+=screenextras_tracing also send every phase to LTTng through Q_TRACE.
+*/
+namespace ScreenTimings
+{
+
+enum Phase
+{
+    PluginLoad,
+    Construction,
+    ScreenQuery,
+    SystemInfo,
+    FormFactor,
+    Fonts,
+    ScreenList,
+    DeviceProbe,
+    PhaseCount
+};
+
+bool isEnabled();
+
+void record(Phase phase, qint64 nsecs);
+
+// milliseconds of the last run of every phase that ran
+QVariantMap toVariantMap();
+
+} // namespace ScreenTimings
+
+class ScreenTimingScope
+{
+public:
+    explicit ScreenTimingScope(ScreenTimings::Phase phase);
+    ~ScreenTimingScope();
+
+private:
+    Q_DISABLE_COPY(ScreenTimingScope)
+
+    ScreenTimings::Phase m_phase;
+    bool m_enabled;
+    QElapsedTimer m_timer;
+};
+
+#endif // SCREENTIMINGS_H
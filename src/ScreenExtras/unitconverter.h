@@ -0,0 +1,106 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef UNITCONVERTER_H
+#define UNITCONVERTER_H
+
+#include "screenmetrics.h"
+#include <cmath>
+
+/*
+  gu(), dp, millimetres and points to pixels and back for C++ code, worked
+  out on one copy of the metrics. Everything is inline and needs neither
+  the ScreenExtras object nor a meta call, so scene graph code can convert
+  thousands of coordinates a frame, from the render thread too.
+
+  QSGNode *MyItem::updatePaintNode(QSGNode *node, UpdatePaintNodeData *)
+  {
+      const UnitConverter units = UnitConverter::current();
+      rectangle->setRect(0, 0, units.gu(10), units.mm(4));
+      ...
+  }
+
+  Pixels are device independent like everywhere else in Qt Quick, use
+  toDevicePixels() for the pixels of the screen. The font sizes are in
+  ScreenMetrics::font().
+*/
+class UnitConverter
+{
+public:
+    constexpr UnitConverter(double gridUnit = 8.0,
+                            double devicePixelRatio = 1.0,
+                            double physicalDotsPerInch = 96.0,
+                            double logicalDotsPerInch = 96.0) :
+        m_gridUnit(gridUnit),
+        m_devicePixelRatio(devicePixelRatio),
+        m_pxPerMm(physicalDotsPerInch / 25.4),
+        m_pxPerPt(logicalDotsPerInch / 72.0)
+    {
+    }
+
+    explicit UnitConverter(const ScreenMetrics &metrics) :
+        UnitConverter(metrics.gridUnit, metrics.devicePixelRatio,
+                      metrics.physicalDotsPerInch, metrics.logicalDotsPerInch)
+    {
+    }
+
+    // of the latest update, safe on any thread
+    static UnitConverter current()
+    {
+        return UnitConverter(*ScreenMetrics::current());
+    }
+
+    constexpr double gridUnit() const { return m_gridUnit; }
+    constexpr double devicePixelRatio() const { return m_devicePixelRatio; }
+
+    // grid units, the same as ScreenExtras.gu()
+    constexpr double gu(double units) const { return units * m_gridUnit; }
+    constexpr double pxToGu(double px) const { return px / m_gridUnit; }
+
+    // an eighth of a grid unit, the same as ScreenExtras.units.dp
+    constexpr double dp(double dp) const { return dp * m_gridUnit / 8.0; }
+    constexpr double pxToDp(double px) const { return px * 8.0 / m_gridUnit; }
+
+    // real world sizes, as good as the physical size the screen reports
+    constexpr double mm(double mm) const { return mm * m_pxPerMm; }
+    constexpr double pxToMm(double px) const { return px / m_pxPerMm; }
+
+    // font points, the way Qt turns a pointSize into pixels
+    constexpr double pt(double pt) const { return pt * m_pxPerPt; }
+    constexpr double pxToPt(double px) const { return px / m_pxPerPt; }
+
+    constexpr double toDevicePixels(double px) const { return px * m_devicePixelRatio; }
+    constexpr double fromDevicePixels(double devicePixels) const { return devicePixels / m_devicePixelRatio; }
+
+    // rounded to the nearest whole device pixel
+    double snap(double px) const { return std::nearbyint(px * m_devicePixelRatio) / m_devicePixelRatio; }
+
+private:
+    double m_gridUnit;
+    double m_devicePixelRatio;
+    double m_pxPerMm;
+    double m_pxPerPt;
+};
+
+#endif // UNITCONVERTER_H
@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "unitkernels.h"
+#include <cmath>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+
+#if defined(__SSE2__)
+/*
+  SSE2 has no rounding instruction and the int conversions give INT_MIN for
+  NaN, infinity and anything out of range. Adding and taking away 2^23
+  rounds like std::nearbyint() instead, and values of 2^23 and over, NaN
+  and infinity included, are whole already and are kept as they are.
+*/
+inline __m128 roundEven(__m128 x)
+{
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 wholeFrom = _mm_set1_ps(8388608.0f);
+    const __m128 magnitude = _mm_andnot_ps(signBit, x);
+    const __m128 rounded = _mm_or_ps(_mm_sub_ps(_mm_add_ps(magnitude, wholeFrom), wholeFrom),
+                                     _mm_and_ps(signBit, x));
+    const __m128 fraction = _mm_cmplt_ps(magnitude, wholeFrom);
+    return _mm_or_ps(_mm_and_ps(fraction, rounded), _mm_andnot_ps(fraction, x));
+}
+
+// the same with 2^52 for doubles
+inline __m128d roundEven(__m128d x)
+{
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d wholeFrom = _mm_set1_pd(4503599627370496.0);
+    const __m128d magnitude = _mm_andnot_pd(signBit, x);
+    const __m128d rounded = _mm_or_pd(_mm_sub_pd(_mm_add_pd(magnitude, wholeFrom), wholeFrom),
+                                      _mm_and_pd(signBit, x));
+    const __m128d fraction = _mm_cmplt_pd(magnitude, wholeFrom);
+    return _mm_or_pd(_mm_and_pd(fraction, rounded), _mm_andnot_pd(fraction, x));
+}
+#endif
+
+} // namespace
+
+namespace UnitKernels
+{
+
+void scale(float *values, int count, float factor)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 f = _mm_set1_ps(factor);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), f));
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(values + i, vmulq_n_f32(vld1q_f32(values + i), factor));
+#endif
+    for (; i < count; ++i)
+        values[i] *= factor;
+}
+
+void scale(double *values, int count, double factor)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128d f = _mm_set1_pd(factor);
+    for (; i + 2 <= count; i += 2)
+        _mm_storeu_pd(values + i, _mm_mul_pd(_mm_loadu_pd(values + i), f));
+#elif defined(__aarch64__)
+    for (; i + 2 <= count; i += 2)
+        vst1q_f64(values + i, vmulq_n_f64(vld1q_f64(values + i), factor));
+#endif
+    for (; i < count; ++i)
+        values[i] *= factor;
+}
+
+// divides like UnitConverter::snap(), so every lane gives the same bits as the plain loop
+void snap(float *values, int count, float devicePixelRatio)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 ratio = _mm_set1_ps(devicePixelRatio);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 devicePixels = roundEven(_mm_mul_ps(_mm_loadu_ps(values + i), ratio));
+        _mm_storeu_ps(values + i, _mm_div_ps(devicePixels, ratio));
+    }
+#elif defined(__aarch64__)
+    const float32x4_t ratio = vdupq_n_f32(devicePixelRatio);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t devicePixels = vrndnq_f32(vmulq_f32(vld1q_f32(values + i), ratio));
+        vst1q_f32(values + i, vdivq_f32(devicePixels, ratio));
+    }
+#endif
+    for (; i < count; ++i)
+        values[i] = std::nearbyint(values[i] * devicePixelRatio) / devicePixelRatio;
+}
+
+void snap(double *values, int count, double devicePixelRatio)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128d ratio = _mm_set1_pd(devicePixelRatio);
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d devicePixels = roundEven(_mm_mul_pd(_mm_loadu_pd(values + i), ratio));
+        _mm_storeu_pd(values + i, _mm_div_pd(devicePixels, ratio));
+    }
+#elif defined(__aarch64__)
+    const float64x2_t ratio = vdupq_n_f64(devicePixelRatio);
+    for (; i + 2 <= count; i += 2)
+    {
+        const float64x2_t devicePixels = vrndnq_f64(vmulq_f64(vld1q_f64(values + i), ratio));
+        vst1q_f64(values + i, vdivq_f64(devicePixels, ratio));
+    }
+#endif
+    for (; i < count; ++i)
+        values[i] = std::nearbyint(values[i] * devicePixelRatio) / devicePixelRatio;
+}
+
+} // namespace UnitKernels
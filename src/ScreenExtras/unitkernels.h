@@ -0,0 +1,62 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef UNITKERNELS_H
+#define UNITKERNELS_H
+
+#include <QVector>
+
+/*
+  Converts whole buffers of coordinates at once, in place. The loops use
+  SSE2 or NEON when the compiler has them turned on and plain C++ for the
+  rest of the buffer and on other CPUs.
+
+  gu to px is scale() by the grid unit, px to gu scale() by one over it,
+  so the last bit can differ from a division. snap() rounds to the
+  nearest whole device pixel, halves go to the even one, and every
+  element comes out the same as in the plain loop, NaN and infinity included.
+*/
+namespace UnitKernels
+{
+
+void scale(float *values, int count, float factor);
+void scale(double *values, int count, double factor);
+
+void snap(float *values, int count, float devicePixelRatio);
+void snap(double *values, int count, double devicePixelRatio);
+
+// these only copy when the vector is shared
+inline void scale(QVector<float> &values, float factor)
+{
+    scale(values.data(), values.size(), factor);
+}
+
+inline void snap(QVector<float> &values, float devicePixelRatio)
+{
+    snap(values.data(), values.size(), devicePixelRatio);
+}
+
+} // namespace UnitKernels
+
+#endif // UNITKERNELS_H
@@ -0,0 +1,416 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#include "windowscreen.h"
+#include <QGuiApplication>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QScreen>
+#include <cmath>
+
+/*!
+   \qmltype WindowScreen
+   \inqmlmodule QmlScreenExtras
+   \brief Attached grid unit and font sizes for the screen that shows the item
+
+   ScreenExtras always works with the primary screen. When windows are spread over
+   screens with a different density use WindowScreen instead, it follows the screen
+   that the window of the item is on. When the window moves to another screen only
+   the bindings inside that window are evaluated again.
+
+     \code
+     Rectangle {
+        width: WindowScreen.units.gu20
+        height: WindowScreen.gridUnit * 4
+        Text {
+            font.pixelSize: WindowScreen.fonts.normal
+        }
+     }
+     \endcode
+
+   Bindings only follow the screen through properties. gu(), pxToGu() and font() are
+   for JavaScript functions, in a binding they need the revision as well.
+
+   Items that are not in a window yet get the values of the primary screen.
+*/
+
+WindowScreenTracker::WindowScreenTracker(QWindow *window, QObject *parent) :
+    QObject(parent),
+    m_window(window),
+    m_core(ScreenExtrasCore::instance()),
+    m_devicePixelRatio(1.0),
+    m_gridUnit(0.0),
+    m_fonts(new ScreenFonts(this)),
+    m_units(new GridUnits(this)),
+    m_revision(0)
+{
+    connect(m_core.data(), &ScreenExtrasCore::pixelSnappingChanged,
+            this, &WindowScreenTracker::update);
+
+    if (m_window)
+    {
+        connect(m_window, &QWindow::screenChanged,
+                this, &WindowScreenTracker::setScreen);
+        setScreen(m_window->screen());
+    }
+    else
+    {
+        connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
+                this, &WindowScreenTracker::setScreen);
+        setScreen(QGuiApplication::primaryScreen());
+    }
+
+    // no screen at all, still hand out the defaults
+    if (m_fonts->isEmpty())
+        update();
+}
+
+WindowScreenTracker *WindowScreenTracker::forWindow(QWindow *window)
+{
+    QObject *owner = window ? static_cast<QObject *>(window) : qGuiApp;
+
+    WindowScreenTracker *tracker =
+            owner->findChild<WindowScreenTracker *>(QString(), Qt::FindDirectChildrenOnly);
+    if (!tracker)
+        tracker = new WindowScreenTracker(window, owner);
+    return tracker;
+}
+
+QScreen *WindowScreenTracker::screen() const
+{
+    return m_screen;
+}
+
+const ScreenProfile &WindowScreenTracker::profile() const
+{
+    return m_profile;
+}
+
+QString WindowScreenTracker::screenName() const
+{
+    return m_screenName;
+}
+
+double WindowScreenTracker::devicePixelRatio() const
+{
+    return m_devicePixelRatio;
+}
+
+double WindowScreenTracker::gridUnit() const
+{
+    return m_gridUnit;
+}
+
+ScreenFonts *WindowScreenTracker::fonts() const
+{
+    return m_fonts;
+}
+
+GridUnits *WindowScreenTracker::units() const
+{
+    return m_units;
+}
+
+int WindowScreenTracker::revision() const
+{
+    return m_revision;
+}
+
+void WindowScreenTracker::setScreen(QScreen *screen)
+{
+    if (m_screen == screen)
+        return;
+
+    if (m_screen)
+        disconnect(m_screen, 0, this, 0);
+
+    m_screen = screen;
+
+    if (m_screen)
+    {
+        connect(m_screen, &QScreen::geometryChanged,
+                this, &WindowScreenTracker::update);
+        connect(m_screen, &QScreen::physicalSizeChanged,
+                this, &WindowScreenTracker::update);
+        connect(m_screen, &QScreen::logicalDotsPerInchChanged,
+                this, &WindowScreenTracker::update);
+        connect(m_screen, &QScreen::physicalDotsPerInchChanged,
+                this, &WindowScreenTracker::update);
+    }
+
+    update();
+}
+
+void WindowScreenTracker::update()
+{
+    const ScreenProfile profile = ScreenProfile::forScreen(m_screen);
+    const QString screenName = m_screen ? m_screen->name() : QString();
+    const double devicePixelRatio = m_screen ? m_screen->devicePixelRatio() : 1.0;
+    const bool snapping = m_core->pixelSnapping();
+
+    // the same rounding as ScreenExtrasCore, so both agree on one screen
+    double gridUnit = profile.gridUnit();
+    if (snapping)
+        gridUnit = qMax(1.0, std::nearbyint(gridUnit * devicePixelRatio)) / devicePixelRatio;
+
+    if (profile.type == m_profile.type
+            && profile.systemType == m_profile.systemType
+            && profile.scaleSize == m_profile.scaleSize
+            && profile.diagonal == m_profile.diagonal
+            && profile.fontSizes == m_profile.fontSizes
+            && screenName == m_screenName
+            && devicePixelRatio == m_devicePixelRatio
+            && gridUnit == m_gridUnit
+            && !m_fonts->isEmpty())
+    {
+        return;
+    }
+
+    m_profile = profile;
+    m_screenName = screenName;
+    m_devicePixelRatio = devicePixelRatio;
+    m_gridUnit = gridUnit;
+
+    double sizes[FontTable::FontCount];
+    if (m_profile.hasFontSizes())
+    {
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = m_profile.fontSizes.at(i);
+    }
+    else
+    {
+        const double *units = FontTable::units(m_profile.type, m_profile.os);
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = units[i] * gridUnit;
+    }
+
+    if (snapping)
+    {
+        for (int i = 0; i < FontTable::FontCount; ++i)
+            sizes[i] = std::nearbyint(sizes[i] * devicePixelRatio) / devicePixelRatio;
+    }
+
+    m_fonts->setSizes(sizes);
+    m_units->setGridUnit(gridUnit);
+    ++m_revision;
+    emit changed();
+}
+
+
+WindowScreen::WindowScreen(QObject *attachee) :
+    QObject(attachee)
+{
+    if (QQuickItem *item = qobject_cast<QQuickItem *>(attachee))
+    {
+        connect(item, &QQuickItem::windowChanged,
+                this, &WindowScreen::onWindowChanged);
+        setTracker(WindowScreenTracker::forWindow(item->window()));
+    }
+    else
+    {
+        setTracker(WindowScreenTracker::forWindow(qobject_cast<QWindow *>(attachee)));
+    }
+}
+
+WindowScreen *WindowScreen::qmlAttachedProperties(QObject *object)
+{
+    return new WindowScreen(object);
+}
+
+void WindowScreen::onWindowChanged(QQuickWindow *window)
+{
+    setTracker(WindowScreenTracker::forWindow(window));
+}
+
+void WindowScreen::setTracker(WindowScreenTracker *tracker)
+{
+    if (m_tracker == tracker)
+        return;
+
+    QScreen *oldScreen = 0;
+    if (m_tracker)
+    {
+        oldScreen = m_tracker->screen();
+        disconnect(m_tracker, 0, this, 0);
+    }
+
+    const bool hadTracker = !m_tracker.isNull();
+    m_tracker = tracker;
+    connect(m_tracker, &WindowScreenTracker::changed,
+            this, &WindowScreen::screenChanged);
+
+    if (hadTracker && oldScreen != m_tracker->screen())
+        emit screenChanged();
+}
+
+WindowScreenTracker *WindowScreen::tracker() const
+{
+    // the window owns the tracker and can go away before its items do
+    if (m_tracker)
+        return m_tracker;
+    return WindowScreenTracker::forWindow(0);
+}
+
+/*!
+ \qmlattachedproperty double WindowScreen::gridUnit
+    The size of one grid unit on the screen of the window, see ScreenExtras::gridUnit
+ */
+double WindowScreen::gridUnit() const
+{
+    return tracker()->gridUnit();
+}
+
+/*!
+ \qmlattachedproperty double WindowScreen::scaleSize
+    The scale that was picked for the screen of the window
+ */
+double WindowScreen::scaleSize() const
+{
+    return tracker()->profile().scaleSize;
+}
+
+/*!
+ \qmlattachedproperty double WindowScreen::displaySize
+    The diagonal in inches of the screen of the window
+ */
+double WindowScreen::displaySize() const
+{
+    return tracker()->profile().diagonal;
+}
+
+/*!
+ \qmlattachedproperty double WindowScreen::devicePixelRatio
+    The device pixel ratio of the screen of the window
+ */
+double WindowScreen::devicePixelRatio() const
+{
+    return tracker()->devicePixelRatio();
+}
+
+/*!
+ \qmlattachedproperty string WindowScreen::formFactor
+    The form factor of the screen of the window, see ScreenExtras::formFactor
+ */
+QString WindowScreen::formFactor() const
+{
+    return tracker()->profile().formFactor;
+}
+
+/*!
+ \qmlattachedproperty enumeration WindowScreen::formFactorType
+    The form factor of the screen of the window, see ScreenExtras::formFactorType
+ */
+int WindowScreen::formFactorType() const
+{
+    return tracker()->profile().type;
+}
+
+/*!
+ \qmlattachedproperty string WindowScreen::screenName
+    The name of the screen of the window
+ */
+QString WindowScreen::screenName() const
+{
+    return tracker()->screenName();
+}
+
+/*!
+ \qmlattachedproperty ScreenFonts WindowScreen::fonts
+    The font sizes for the screen of the window, see ScreenExtras::fonts
+
+     \code
+     Text{
+        font.pixelSize: WindowScreen.fonts.normal
+     }
+     \endcode
+ */
+ScreenFonts *WindowScreen::fonts() const
+{
+    return tracker()->fonts();
+}
+
+/*!
+ \qmlattachedproperty GridUnits WindowScreen::units
+    Common grid unit sizes for the screen of the window, see ScreenExtras::units
+
+     \code
+     Rectangle {
+        width: WindowScreen.units.gu10
+     }
+     \endcode
+ */
+GridUnits *WindowScreen::units() const
+{
+    return tracker()->units();
+}
+
+/*!
+ \qmlattachedproperty int WindowScreen::revision
+    Goes up whenever the values for the screen of the window changed. Pass it to gu(),
+    pxToGu() or font() to have a binding evaluated again.
+ */
+int WindowScreen::revision() const
+{
+    return tracker()->revision();
+}
+
+/*!
+ \qmlattachedmethod WindowScreen::gu(double units, int revision)
+    Same as ScreenExtras::gu() but for the screen of the window. A method call does not
+    make a binding depend on the screen, so in a binding pass revision or use gridUnit.
+
+     \code
+     Rectangle {
+        width: WindowScreen.gu(20, WindowScreen.revision)
+     }
+     \endcode
+ */
+double WindowScreen::gu(double units, int revision) const
+{
+    Q_UNUSED(revision)
+    return units * gridUnit();
+}
+
+double WindowScreen::pxToGu(double px, int revision) const
+{
+    Q_UNUSED(revision)
+    return px / gridUnit();
+}
+
+/*!
+ \qmlattachedmethod WindowScreen::font(Font, int revision)
+    Same as ScreenExtras::font() but for the screen of the window. In a binding use
+    fonts or pass revision.
+
+     \code
+     Text{
+        font.pixelSize: WindowScreen.font(ScreenExtras.NORMAL, WindowScreen.revision)
+     }
+     \endcode
+ */
+double WindowScreen::font(int fontSize, int revision) const
+{
+    Q_UNUSED(revision)
+    return tracker()->fonts()->size(fontSize);
+}
@@ -0,0 +1,134 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Joseph Mills <josephjamesmills@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+*/
+
+#ifndef WINDOWSCREEN_H
+#define WINDOWSCREEN_H
+
+#include <QObject>
+#include <QPointer>
+#include <QtQml>
+
+#include "screen.h"
+#include "screenprofile.h"
+#include "screenfonts.h"
+#include "gridunits.h"
+
+class QQuickWindow;
+class QScreen;
+class QWindow;
+
+// Follows the screen of one window, shared by every WindowScreen in that window
+class WindowScreenTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // A null window gives the tracker that follows the primary screen
+    static WindowScreenTracker *forWindow(QWindow *window);
+
+    QScreen *screen() const;
+    const ScreenProfile &profile() const;
+    QString screenName() const;
+    double devicePixelRatio() const;
+    // snapped to whole device pixels when ScreenExtras.pixelSnapping is on
+    double gridUnit() const;
+    ScreenFonts *fonts() const;
+    GridUnits *units() const;
+    // goes up with every change
+    int revision() const;
+
+signals:
+    void changed();
+
+protected slots:
+    void setScreen(QScreen *screen);
+    void update();
+
+private:
+    explicit WindowScreenTracker(QWindow *window, QObject *parent);
+
+    QWindow *m_window;
+    QSharedPointer<ScreenExtrasCore> m_core;
+    QPointer<QScreen> m_screen;
+    ScreenProfile m_profile;
+    QString m_screenName;
+    double m_devicePixelRatio;
+    double m_gridUnit;
+    ScreenFonts *m_fonts;
+    GridUnits *m_units;
+    int m_revision;
+};
+
+class WindowScreen : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY( double gridUnit READ gridUnit NOTIFY screenChanged )
+    Q_PROPERTY( double scaleSize READ scaleSize NOTIFY screenChanged )
+    Q_PROPERTY( double displaySize READ displaySize NOTIFY screenChanged )
+    Q_PROPERTY( double devicePixelRatio READ devicePixelRatio NOTIFY screenChanged )
+    Q_PROPERTY( QString formFactor READ formFactor NOTIFY screenChanged )
+    Q_PROPERTY( int formFactorType READ formFactorType NOTIFY screenChanged )
+    Q_PROPERTY( QString screenName READ screenName NOTIFY screenChanged )
+    Q_PROPERTY( ScreenFonts *fonts READ fonts NOTIFY screenChanged )
+    Q_PROPERTY( GridUnits *units READ units NOTIFY screenChanged )
+    Q_PROPERTY( int revision READ revision NOTIFY screenChanged )
+
+public:
+    explicit WindowScreen( QObject *attachee );
+
+    static WindowScreen *qmlAttachedProperties(QObject *object);
+
+    double gridUnit() const;
+    double scaleSize() const;
+    double displaySize() const;
+    double devicePixelRatio() const;
+    QString formFactor() const;
+    int formFactorType() const;
+    QString screenName() const;
+    ScreenFonts *fonts() const;
+    GridUnits *units() const;
+    int revision() const;
+
+    // the revision is only there so that bindings are evaluated again when it changes
+    Q_INVOKABLE double gu(double units, int revision = 0) const;
+    Q_INVOKABLE double pxToGu(double px, int revision = 0) const;
+    Q_INVOKABLE double font(int fontSize, int revision = 0) const;
+
+signals:
+    void screenChanged();
+
+protected slots:
+    void onWindowChanged(QQuickWindow *window);
+
+private:
+    void setTracker(WindowScreenTracker *tracker);
+    WindowScreenTracker *tracker() const;
+
+    QPointer<WindowScreenTracker> m_tracker;
+};
+
+QML_DECLARE_TYPEINFO(WindowScreen, QML_HAS_ATTACHED_PROPERTIES)
+
+#endif // WINDOWSCREEN_H